@@ -1,298 +1,142 @@
 #include <iostream>
 #include <cstdlib>
+#include <cmath>
 #include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
 #include <vector>
-#include <queue>
-#include <stack>
 #include <chrono>
 #include <algorithm>
-#include <random>
+#include <cctype>
+
+#include "cacheSim.h"
+#include "compressedGraph.h"
+#include "gorder.h"
+#include "graph.h"
+#include "graphIO.h"
+#include "kernels.h"
+#include "metrics.h"
+#include "order.h"
+#include "orderings.h"
+#include "outOfCore.h"
+#include "parallel.h"
+#include "partition.h"
+#include "rabbitOrder.h"
+#include "rcm.h"
+#include "segmentedGraph.h"
+#include "traversal.h"
 
 using namespace std;
 
-struct Node {
-    int id;
-    int numOfDegree;
-};
-
-struct Edge {
-    int src;
-    int dst;
-};
-
-// 降序排列
-bool moreThan( Node a, Node b ) {
-    return a.numOfDegree > b.numOfDegree;
-} // moreThan
-
-// 升序
-bool srcLessThan( Edge a, Edge b ) {
-    return a.src < b.src;
-} // srcLessThan
-
-void init( string fileName, vector<Edge> edgeList ) {
-    ifstream inputFile( fileName );
-    if ( !inputFile ) {
-        cerr << "Error: Unable to open input file." << endl;
-        exit(1);
-    } // if
-
-    // konect 資料集中，開頭兩行需去除
-    char temp;
-    temp = inputFile.peek();
-    while ( temp == '%' ) {
-        inputFile.get(temp);
-        while ( temp != '\n' )
-            inputFile.get(temp);
+// 印出輸出檔案的時間與速度
+void printWriteCost( const string & label, chrono::steady_clock::time_point start, uint64_t bytes, ostream & out = cout ) {
+    double ms = chrono::duration<double, milli>( chrono::steady_clock::now() - start ).count();
+    out << label << " Time Cost: " << ms << "ms ( " << ( ms > 0 ? bytes / ( ms * 1000 ) : 0 ) << " MB/s )" << endl;
+} // printWriteCost
 
-        temp = inputFile.peek();
-    } // while
-
-    int node1, node2;
-    int startID = 0;
-
-    inputFile >> node1 >> node2;
-
-    edgeList.push_back({node1, node2});
-    if ( node1 <= node2 )
-        startID = node1;
-    else
-        startID = node2;
-
-    // 讀取邊緣列表數據
-    while ( inputFile >> node1 >> node2 ) {
-        edgeList.push_back({node1, node2});
-        if ( node1 < startID )
-            startID = node1;
-        if ( node2 < startID )
-            startID = node2;
-    } // while
+void init( string fileName ) {
+    // konect 資料集中開頭的 % 註解行由 loadEdgeList 略過
+    EdgeList list;
+    vector<Edge> & edgeList = list.edges;
+    int minID = 0, maxID = -1;
+    loadEdgeList( fileName, edgeList, minID, maxID );
 
+    int startID = minID;
     if ( startID != 0 ) {
-        for ( int i = 0; i < edgeList.size(); i++ ) {
-            edgeList.at(i).src = edgeList.at(i).src - startID;
-            edgeList.at(i).dst = edgeList.at(i).dst - startID;
-        } // for
+        parallelFor( 0, edgeList.size(), [&]( int, size_t lo, size_t hi ) {
+            for ( size_t i = lo; i < hi; i++ ) {
+                edgeList[i].src = edgeList[i].src - startID;
+                edgeList[i].dst = edgeList[i].dst - startID;
+            } // for
+        } );
     } // if
 
-    inputFile.close();
-
-    string name = fileName.substr( 0, fileName.find(".") );
-    ofstream outputFile( name + ".txt" );
-    for ( int i = 0; i < edgeList.size(); i++ ) {
-        outputFile << edgeList.at(i).src << " ";
-        outputFile << edgeList.at(i).dst << "\n";
-    } // for
-    outputFile.close();
+    auto start = chrono::steady_clock::now();
+    printWriteCost( "WriteEdgeList", start, writeEdgeListFile( fileName, list, "" ) );
 } // init
 
-void readEdgeList( string fileName, vector<Edge> & edgeList, int & numOfNodes ) {
-    ifstream inputFile( fileName );
-    if ( !inputFile ) {
-        cerr << "Error: Unable to open input file." << endl;
-        exit(1);
-    } // if
-
-    int node1, node2;
-
-    // 讀取邊緣列表數據
-    while ( inputFile >> node1 >> node2 ) {
-        edgeList.push_back({node1, node2});
-        if ( node1 > numOfNodes )
-            numOfNodes = node1;
-        if ( node2 > numOfNodes )
-            numOfNodes = node2;
-    } // while
-
-    numOfNodes++;
-    inputFile.close();
+void readEdgeList( string fileName, EdgeList & edgeList ) {
+    auto start = chrono::steady_clock::now();
+    loadEdgeList( fileName, edgeList );
+    auto end = chrono::steady_clock::now();
+    cout << "ReadEdgeList Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
 } // readEdgeList
 
-void readCSR( string fileName, vector<int> & csrOffsetArray, vector<int> & csrEdgeArray ) {
-    ifstream inputFile( fileName );
-    if ( !inputFile ) {
-        cerr << "Error: Unable to open input file." << endl;
-        exit(1);
+template <class EdgeID>
+void buildCSR( const EdgeList & edgeList, BasicCsrGraph<int, EdgeID> & graph ) {
+    // 並行建構，用牆上時間計時
+    auto start = chrono::steady_clock::now();
+    convertToCSR( edgeList, graph );
+    auto end = chrono::steady_clock::now();
+    cout << "ConvertToCSR Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
+} // buildCSR
+
+// 依 permutation 產生新的 CSR（reordered，含 permutation），輸出依 src、dst 排序的 edge list、
+// 含 permutation 的二進位 CSR（<name>_<ordering>CSR.bin）與 permutation 檔（<name>_<ordering>_perm.bin）；訊息寫到 out
+template <class EdgeID>
+void writeReorderedGraph( string fileName, const string & orderingName, const BasicCsrGraph<int, EdgeID> & graph,
+                          const Permutation & permutation, BasicCsrGraph<int, EdgeID> & reordered, ostream & out = cout ) {
+    auto start = chrono::steady_clock::now();
+    applyPermutation( graph, permutation, reordered );
+    auto end = chrono::steady_clock::now();
+    out << "ApplyPermutation Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
+
+    string oper = "_" + orderingName;
+    start = chrono::steady_clock::now();
+    printWriteCost( "WriteEdgeList", start, writeEdgeListFile( fileName, reordered, oper ), out );
+    start = chrono::steady_clock::now();
+    printWriteCost( "WriteCSR", start, writeCSRBinaryFile( outputBaseName( fileName ) + oper + "CSR.bin", reordered, reordered.permutation ), out );
+    start = chrono::steady_clock::now();
+    printWriteCost( "WritePermutation", start, writePermutationFile( permutationFileName( fileName, oper ), permutation ), out );
+} // writeReorderedGraph
+
+// 算出新的編號後以 writeReorderedGraph 輸出
+// reportShape 為 true 時印出重新編號前後矩陣的 bandwidth 與 profile
+template <class EdgeID>
+void reorderGraph( string fileName, const Ordering & ordering, const BasicCsrGraph<int, EdgeID> & graph, bool reportShape,
+                   BasicCsrGraph<int, EdgeID> & reordered, ostream & out = cout ) {
+    auto start = chrono::steady_clock::now();
+    Permutation permutation = ordering.compute( graph );
+    auto end = chrono::steady_clock::now();
+    out << ordering.name() << " Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
+
+    if ( reportShape ) {
+        MatrixShape before = matrixShape( graph );
+        MatrixShape after = matrixShape( graph, &permutation );
+        out << "Bandwidth: " << before.bandwidth << " -> " << after.bandwidth << endl;
+        out << "Profile: " << before.profile << " -> " << after.profile << endl;
     } // if
 
-    char ch;
-    int offset = 0, edge = 0;
-
-    while( inputFile.get(ch) && ch != '\n' ) {
-        if ( isdigit(ch) )
-            offset = offset * 10 + ( ch - '0' );
-        else if ( ch == ' ' ) {
-            csrOffsetArray.push_back(offset);
-            offset = 0;
-        } // else if
-        else {
-            cout << "file illegal";
-            exit(1);
-        } // else
-    } // while
-
-    while( inputFile.get(ch) ) {
-        if ( isdigit(ch) )
-            edge = edge * 10 + ( ch - '0' );
-        else if ( ch == ' ' ) {
-            csrEdgeArray.push_back(edge);
-            edge = 0;
-        } // else if
-        else {
-            cout << "file illegal";
-            exit(1);
-        } // else
-    } // while
-
-    inputFile.close();
-} // readCSR
-
-// 將圖的edge list格式轉換為CSR格式
-void convertToCSR( vector<Edge> & edgeList, vector<int> & csrOffsetArray, vector<int> & csrEdgeArray ) {
-    int numNodes = 0;
-
-    // 確定節點數量
-    for ( auto & edge : edgeList )
-        numNodes = max( numNodes, max( edge.src, edge.dst ) + 1 );
-
-    csrOffsetArray.resize( numNodes + 1, 0 );
-
-    // 計算每個節點的鄰居數量
-    for ( auto & edge : edgeList )
-        csrOffsetArray.at(edge.src + 1)++;
-
-    // 累積計算每個節點的起始位置
-    for ( int i = 1; i <= numNodes; i++ )
-        csrOffsetArray.at(i) += csrOffsetArray.at(i - 1);
-    // ---------------------------------------- csrOffsetArray 完成
-    csrEdgeArray.resize( edgeList.size() );
-
-    // 將邊緣列表中的節點添加到對應的位置
-    vector<int> next_idx( numNodes, 0 );
-
-    for ( auto & edge : edgeList ) {
-        int node1 = edge.src;
-        int node2 = edge.dst;
-        int idx = csrOffsetArray.at(node1) + next_idx.at(node1);
-        csrEdgeArray.at(idx) = node2;
-        next_idx.at(node1)++;
-    } // for
-    // ---------------------------------------- csrEdgeArray 完成
-
-} // convertToCSR
-
-vector <int> shuffleList( int numOfNodes ) {
-    vector <int> v;
-    for ( int i = 0; i < numOfNodes; i++ )
-        v.push_back(i);
-
-    unsigned seed = 0;
-    shuffle( v.begin(), v.end(), default_random_engine(seed));
-
-    return v;
-} // shuffleList
-
-void randomOrder( vector<Edge> & edgeList, int numOfNodes ) {
-    vector <int> randomList;
-    for ( int i = 0; i < numOfNodes; i++ )
-        randomList.push_back(i);
-
-    unsigned seed = 0;
-    shuffle( randomList.begin(), randomList.end(), default_random_engine(seed));
-
-    int temp = 0;
-    for ( int i = 0; i < edgeList.size(); i++ ) {
-        temp = edgeList.at(i).src;
-        edgeList.at(i).src = randomList.at(temp);
-        temp = edgeList.at(i).dst;
-        edgeList.at(i).dst = randomList.at(temp);
-    } // for
-} // randomOrder
-
-void degreeSort( vector<Edge> & edgeList, int numOfNodes ) {
-    vector<Node> inDegreeList( numOfNodes, {0, 0} );
-    vector<Node> outDegreeList( numOfNodes, {0, 0} );
-
-    // 把 ID 設定好
-    for ( int i = 0; i < numOfNodes; i++ ) {
-        outDegreeList.at(i).id = i;
-        inDegreeList.at(i).id = i;
-    } // for
-
-    // 紀錄每個 node 的 in/out degree
-    int numOfEdges = edgeList.size();
-    // for ( int i = 0; i < numOfEdges; i++ )
-    //     outDegreeList.at(edgeList.at(i).at(0)).numOfDegree++;
-
-    for ( int i = 0; i < numOfEdges; i++ )
-        inDegreeList.at(edgeList.at(i).dst).numOfDegree++;
-
-    sort( inDegreeList.begin(), inDegreeList.end(), moreThan );
-
-    int temp = 0;
-    for ( int i = 0; i < edgeList.size(); i++ ) {
-        temp = edgeList.at(i).src;
-        edgeList.at(i).src = inDegreeList.at(temp).id;
-        temp = edgeList.at(i).dst;
-        edgeList.at(i).dst = inDegreeList.at(temp).id;
-    } // for
-
-} // degreeSort
-
-void hubCluster( vector<Edge> & edgeList, int numOfNodes ) {
-    vector<Node> inDegreeList( numOfNodes, {0, 0} );
-    vector<Node> outDegreeList( numOfNodes, {0, 0} );
-
-    // 把 ID 設定好
-    for ( int i = 0; i < numOfNodes; i++ ) {
-        outDegreeList.at(i).id = i;
-        inDegreeList.at(i).id = i;
-    } // for
-
-    // 紀錄每個 node 的 in/out degree
-    int numOfEdges = edgeList.size();
-    // for ( int i = 0; i < numOfEdges; i++ )
-    //     outDegreeList.at(edgeList.at(i).at(0)).numOfDegree++;
-
-    for ( int i = 0; i < numOfEdges; i++ )
-        inDegreeList.at(edgeList.at(i).dst).numOfDegree++;
-
-    // 算出平均 degree
-    int sum = 0;
-    for ( int i = 0; i < numOfNodes; i++ )
-        sum += inDegreeList.at(i).numOfDegree;
-
-    int averageDegree = sum / numOfNodes;
-
-    vector<int> hot;
-    vector<int> cold;
-    for ( int i = 0; i < numOfNodes; i++ ) {
-        if ( inDegreeList.at(i).numOfDegree > averageDegree )
-            hot.push_back( inDegreeList.at(i).id );
-        else
-            cold.push_back( inDegreeList.at(i).id );
-    } // for
-
-    int temp = 0;
-    vector<int> newOrder;
-    newOrder.insert( newOrder.end(), hot.begin(), hot.end() );
-    newOrder.insert( newOrder.end(), cold.begin(), cold.end() );
-    for ( int i = 0; i < edgeList.size(); i++ ) {
-        temp = edgeList.at(i).src;
-        edgeList.at(i).src = newOrder.at(temp);
-        temp = edgeList.at(i).dst;
-        edgeList.at(i).dst = newOrder.at(temp);
-    } // for
-
-} // hubCluster
+    writeReorderedGraph( fileName, ordering.name(), graph, permutation, reordered, out );
+} // reorderGraph
+
+// 讀 edge list 建 CSR 後重新編號；邊數超過 INT_MAX 時改用 64 位元 offsets 的 CsrGraph64
+// reportShape 為 true 時印出重新編號前後矩陣的 bandwidth 與 profile
+void reorder( string fileName, const Ordering & ordering, bool reportShape = false ) {
+    EdgeList edgeList;
+    readEdgeList( fileName, edgeList );
+    if ( needsWideOffsets( edgeList.edges.size() ) ) {
+        CsrGraph64 graph, reordered;
+        buildCSR( edgeList, graph );
+        vector<Edge>().swap( edgeList.edges );
+        reorderGraph( fileName, ordering, graph, reportShape, reordered );
+    } // if
+    else {
+        CsrGraph graph, reordered;
+        buildCSR( edgeList, graph );
+        vector<Edge>().swap( edgeList.edges );
+        reorderGraph( fileName, ordering, graph, reportShape, reordered );
+    } // else
+} // reorder
 
 // 輸入 CSR 圖的 offset array，輸出最大 degree 的 index
-int findMaxDegreeIndex( vector<int> csrOffsetArray ) {
+int findMaxDegreeIndex( const CsrGraph & graph ) {
     int max = 0;
     int numNeighbor = 0;
     int index = -1;
-    for ( int i = 1; i < csrOffsetArray.size(); i++ ) {
-        numNeighbor = csrOffsetArray.at(i) - csrOffsetArray.at(i-1);
+    for ( int i = 1; i <= graph.numOfNodes; i++ ) {
+        numNeighbor = graph.offsets[i] - graph.offsets[i-1];
         if ( max < numNeighbor ) {
             max = numNeighbor;
             index = i-1;
@@ -304,108 +148,293 @@ int findMaxDegreeIndex( vector<int> csrOffsetArray ) {
     return index;
 } // findMaxDegreeIndex
 
-// 廣度優先搜索 (BFS)
-vector <int> bfs( vector<int> csrOffsetArray, vector<int> csrEdgeArray, int startNode ) {
-    int numNodes = csrOffsetArray.size() - 1;
-    vector <int> result;
-
-    // 記錄節點是否被訪問過
-    vector<bool> visited( numNodes, false );
-
-    // 起始節點先 push 進 queue
-    queue<int> q;
-    q.push(startNode);
-    visited.at(startNode) = true;
+// 印出區域性指標
+void printLocalityMetrics( const LocalityMetrics & metrics ) {
+    cout << "Average Gap: " << metrics.averageGap << endl;
+    cout << "Average Log Gap: " << metrics.averageLogGap << endl;
+    cout << "Average Edge Span: " << metrics.averageEdgeSpan << endl;
+    cout << "Bandwidth: " << metrics.bandwidth << endl;
+    cout << "Profile: " << metrics.profile << endl;
+    cout << "Cache Line Share: " << metrics.cacheLineShare << endl;
+    cout << "Hub Concentration:";
+    for ( int percent : { 1, 5, 10, 25, 50 } )
+        cout << " " << percent << "%=" << metrics.hubConcentration[percent - 1];
+    cout << endl;
+} // printLocalityMetrics
+
+void printPartitionStats( const PartitionStats & stats ) {
+    cout << "Edge Cut: " << stats.edgeCut << " / " << stats.numEdges << " ( "
+         << ( stats.numEdges > 0 ? 100.0 * stats.edgeCut / stats.numEdges : 0 ) << "% )" << endl;
+    cout << "Part Size: " << stats.minPartSize << " ~ " << stats.maxPartSize << ", Balance: " << stats.balance << endl;
+} // printPartitionStats
+
+void printCacheStats( const string & walk, const CacheStats & stats, bool hasL2 ) {
+    cout << walk << " Miss Rate: " << stats.missRate() << " ( property " << stats.propertyMissRate() << " )";
+    if ( hasL2 )
+        cout << ", L2 Miss Rate: " << stats.l2MissRate();
+    cout << endl;
+} // printCacheStats
+
+// degree 系列的排序依據，讀不到時使用 in-degree
+DegreeType getDegreeType() {
+    cout << "Please input the degree type ( 0: in, 1: out, 2: total ): ";
+    int type = 0;
+    cin >> type;
+    if ( type == 1 )
+        return OUT_DEGREE;
+    if ( type == 2 )
+        return TOTAL_DEGREE;
+    return IN_DEGREE;
+} // getDegreeType
+
+// ---------------------------------------- 批次模式
+// 圖只讀一次，依序（或同時數個）跑多種 reordering，各自輸出 edge list 與二進位 CSR，再跑指定的 kernel：
+//   all <graph> [ -o ordering,... ] [ -k kernel,... ] [ -j 同時執行的 reordering 數 ]
+//   all -f <job file>
+// job file 每行一個指令：graph <file> 開始一個新的工作，之後的 ordering / kernel / jobs 都屬於它，
+// 名稱以逗號分隔，all 表示全部（不分大小寫，讀圖前先檢查），# 之後為註解。沒有參數時使用互動選單
+
+const int BATCH_PAGERANK_ITERATIONS = 20;
+const int BATCH_SSSP_DELTA = 32;
+
+struct BatchJob {
+    string fileName;
+    vector<string> orderings;
+    vector<string> kernels;
+    int concurrency = 1;
+};
 
-    while ( !q.empty() ) {
-        int currentNode = q.front();
-        q.pop();
+inline vector<string> kernelNames() {
+    return { "PageRankPull", "PageRankPush", "SSSP", "CC", "BFS" };
+} // kernelNames
+
+// 把逗號分隔的名稱加到 names，all 換成 allNames
+void appendNames( const string & text, const vector<string> & allNames, vector<string> & names ) {
+    stringstream ss( text );
+    string name;
+    while ( getline( ss, name, ',' ) ) {
+        if ( name == "all" )
+            names.insert( names.end(), allNames.begin(), allNames.end() );
+        else if ( !name.empty() )
+            names.push_back( name );
+    } // while
+} // appendNames
+
+// 設定工作的一個欄位，key 不認得時回傳 false
+bool setJobField( BatchJob & job, const string & key, const string & value ) {
+    if ( key == "ordering" || key == "-o" )
+        appendNames( value, orderingNames(), job.orderings );
+    else if ( key == "kernel" || key == "-k" )
+        appendNames( value, kernelNames(), job.kernels );
+    else if ( key == "jobs" || key == "-j" )
+        job.concurrency = max( 1, atoi( value.c_str() ) );
+    else
+        return false;
+    return true;
+} // setJobField
 
-        // 找到目標
-        result.push_back(currentNode);
+vector<BatchJob> readJobFile( const string & fileName ) {
+    ifstream inputFile( fileName );
+    if ( !inputFile ) {
+        cerr << "Error: Unable to open job file." << endl;
+        exit(1);
+    } // if
 
-        // 將當前節點的鄰居節點加入 queue
-        for ( int i = csrOffsetArray.at(currentNode); i < csrOffsetArray.at(currentNode + 1); i++ ) {
-            int neighbor = csrEdgeArray.at(i);
+    vector<BatchJob> jobs;
+    string line;
+    for ( int lineNumber = 1; getline( inputFile, line ); lineNumber++ ) {
+        stringstream ss( line.substr( 0, line.find( '#' ) ) );
+        string key, value;
+        if ( !( ss >> key ) )
+            continue;
+
+        ss >> value;
+        if ( key == "graph" && !value.empty() ) {
+            jobs.push_back( BatchJob() );
+            jobs.back().fileName = value;
+        } // if
+        else if ( jobs.empty() || value.empty() || !setJobField( jobs.back(), key, value ) ) {
+            cerr << "Error: job file line " << lineNumber << " is illegal." << endl;
+            exit(1);
+        } // else if
+    } // for
 
-            // 如果鄰居節點尚未被訪問過
-            if ( !visited.at(neighbor) ) {
-                q.push(neighbor);
-                visited.at(neighbor) = true;
-            } // if
-        } // for
-    } // while
+    return jobs;
+} // readJobFile
 
-    return result;
-} // bfs
+// 名稱不分大小寫對應到 allNames 中的名稱，找不到時回傳空字串
+string canonicalName( const string & name, const vector<string> & allNames ) {
+    auto lower = []( string text ) {
+        for ( char & c : text )
+            c = tolower( (unsigned char)c );
+        return text;
+    };
 
-// 深度優先搜索 (DFS)
-vector<int> dfs( vector<int> csrOffsetArray, vector<int> csrEdgeArray, int startNode ) {
-    int numNodes = csrOffsetArray.size() - 1;
-    vector<bool> visited( numNodes, false );
-    vector <int> result;;
+    for ( const string & candidate : allNames ) {
+        if ( lower( candidate ) == lower( name ) )
+            return candidate;
+    } // for
 
-    stack<int> s;
-    s.push(startNode);
-    visited.at(startNode) = true;
+    return "";
+} // canonicalName
+
+// 在讀圖與計算之前檢查 ordering / kernel 的名稱（不分大小寫，換成正式名稱），
+// 有不認得的名稱時列出可用的名稱並結束
+void validateNames( vector<string> & names, const vector<string> & allNames, const string & kind ) {
+    for ( string & name : names ) {
+        string canonical = canonicalName( name, allNames );
+        if ( canonical.empty() ) {
+            cerr << "Error: unknown " << kind << " " << name << ", valid names:";
+            for ( const string & valid : allNames )
+                cerr << " " << valid;
+            cerr << endl;
+            exit(1);
+        } // if
 
-    while ( !s.empty() ) {
-        int currentNode = s.top();
-        s.pop();
+        name = canonical;
+    } // for
+} // validateNames
 
-        // 找到目標
-        result.push_back(currentNode);
+vector<BatchJob> parseArguments( int argc, char * argv[] ) {
+    vector<BatchJob> jobs;
+    if ( string( argv[1] ) == "-f" ) {
+        if ( argc != 3 ) {
+            cerr << "Error: usage: all -f <job file>" << endl;
+            exit(1);
+        } // if
 
-        // 將當前節點的鄰接節點加入堆疊（反向加入）
-        for ( int i = csrOffsetArray.at(currentNode + 1) - 1; i >= csrOffsetArray.at(currentNode); i-- ) {
-            int neighbor = csrEdgeArray.at(i);
-            if ( !visited.at(neighbor) ) {
-                s.push(neighbor);
-                visited.at(neighbor) = true;
+        jobs = readJobFile( argv[2] );
+    } // if
+    else {
+        BatchJob job;
+        job.fileName = argv[1];
+        for ( int i = 2; i < argc; i += 2 ) {
+            if ( i + 1 == argc || !setJobField( job, argv[i], argv[i + 1] ) ) {
+                cerr << "Error: usage: all <graph> [ -o ordering,... ] [ -k kernel,... ] [ -j jobs ]" << endl;
+                exit(1);
             } // if
         } // for
-    } // while
 
-    return result;
-} // dfs
-
-// 把 CSR 寫入檔案
-void writeCSRFile( string fileName, vector<int> csrOffsetArray, vector<int> csrEdgeArray ) {
-    string name = fileName.substr( 0, fileName.find(".") );
-    ofstream outputFile( name + "CSR.txt" );
+        jobs.push_back( job );
+    } // else
 
-    for ( int val : csrOffsetArray )
-        outputFile << val << " ";
+    for ( BatchJob & job : jobs ) {
+        validateNames( job.orderings, orderingNames(), "ordering" );
+        validateNames( job.kernels, kernelNames(), "kernel" );
+    } // for
 
-    outputFile << "\n";
+    return jobs;
+} // parseArguments
+
+// 在重新編號後的圖（含 permutation）上跑 kernel，source 為原圖的起點
+void runKernels( const CsrGraph & graph, int source, const vector<string> & kernels, const string & name ) {
+    if ( kernels.empty() )
+        return;
+
+    CsrGraph inGraph, undirected;
+    transposeCSR( graph, inGraph );
+    if ( find( kernels.begin(), kernels.end(), "CC" ) != kernels.end() )
+        symmetrizeCSR( graph, inGraph, undirected );
+
+    Permutation permutation;
+    permutation.newID.assign( graph.permutation, graph.permutation + graph.numOfNodes );
+    int newSource = source >= 0 ? permutation.newID[source] : -1;
+    for ( const string & kernel : kernels ) {
+        vector<int> weight;
+        if ( kernel == "SSSP" )
+            weight = originalEdgeWeights( graph, inversePermutation( permutation ) );
+
+        auto start = chrono::steady_clock::now();
+        if ( kernel == "PageRankPull" )
+            pageRankPull( graph, inGraph, BATCH_PAGERANK_ITERATIONS );
+        else if ( kernel == "PageRankPush" )
+            pageRankPush( graph, BATCH_PAGERANK_ITERATIONS );
+        else if ( kernel == "SSSP" )
+            deltaSteppingSSSP( graph, weight, newSource, BATCH_SSSP_DELTA );
+        else if ( kernel == "CC" ) {
+            int iterations = 0;
+            labelPropagationCC( undirected, iterations );
+        } // else if
+        else if ( kernel == "BFS" )
+            directionOptimizingBFS( graph, &inGraph, newSource );
+        else {
+            cout << "unknown kernel: " << kernel << endl;
+            continue;
+        } // else
 
-    for ( int val : csrEdgeArray )
-        outputFile << val << " ";
+        auto end = chrono::steady_clock::now();
+        cout << name << " " << kernel << " Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
+    } // for
+} // runKernels
+
+void runKernels( const CsrGraph64 &, int, const vector<string> & kernels, const string & ) {
+    if ( !kernels.empty() )
+        cout << "kernels support at most " << INT_MAX << " edges, skipped" << endl;
+} // runKernels
+
+// 一個工作：reordering 每 concurrency 個一組同時執行（各自的訊息先暫存，完成後依序印出），
+// 一組完成後再逐一跑 kernel，kernel 的時間不受其他 reordering 影響
+template <class EdgeID>
+void runBatchJob( const BatchJob & job, const BasicCsrGraph<int, EdgeID> & graph ) {
+    int source = -1;
+    for ( int v = 0; v < graph.numOfNodes; v++ ) {
+        if ( source == -1 || graph.degree( v ) > graph.degree( source ) )
+            source = v;
+    } // for
 
-    outputFile.close();
-} // writeCSRFile
+    vector<unique_ptr<Ordering>> orderings;
+    for ( const string & name : job.orderings ) {
+        unique_ptr<Ordering> ordering = makeOrdering( name );
+        if ( ordering == nullptr )
+            cout << "unknown ordering: " << name << endl;
+        else
+            orderings.push_back( move( ordering ) );
+    } // for
 
-// 把 reordering 後的 edgeList 寫入檔案
-void writeEdgeListFile( string fileName, vector<Edge> edgeList, string oper ) {
-    srand(time(0));
-    clock_t start, end;
-    start=clock();
-    sort( edgeList.begin(), edgeList.end(), srcLessThan );
-    end=clock();
-    cout << "SortEdgeList Time Cost: " << (1000.0)*(double)(end-start)/CLOCKS_PER_SEC << "ms" << endl;
+    // 每個同時執行的 reordering 約需原圖三倍的記憶體（新的 CSR、permutation 與計算用的空間）
+    uint64_t graphBytes = ( graph.numOfNodes + 1ULL ) * sizeof( EdgeID ) + (uint64_t)graph.numOfEdges * sizeof( int ) +
+                          (uint64_t)graph.numOfNodes * sizeof( int );
+    uint64_t available = (uint64_t)sysconf( _SC_AVPHYS_PAGES ) * sysconf( _SC_PAGESIZE );
+    size_t concurrency = max<uint64_t>( 1, min<uint64_t>( job.concurrency, available / max<uint64_t>( 3 * graphBytes, 1 ) ) );
+    if ( concurrency < (size_t)job.concurrency )
+        cout << "available memory limits concurrent orderings to " << concurrency << endl;
+
+    // 同時執行的 reordering 平分執行緒，避免超出核心數
+    int jobThreads = max<int>( 1, numOfThreads() / concurrency );
+    for ( size_t first = 0; first < orderings.size(); first += concurrency ) {
+        size_t count = min( orderings.size() - first, concurrency );
+        vector<BasicCsrGraph<int, EdgeID>> reordered( count );
+        vector<ostringstream> logs( count );
+        vector<thread> threads;
+        for ( size_t i = 0; i < count; i++ ) {
+            threads.emplace_back( [&, i]() {
+                ThreadLimit limit( jobThreads );
+                reorderGraph( job.fileName, *orderings[first + i], graph, false, reordered[i], logs[i] );
+            } );
+        } // for
 
-    string name = fileName.substr( 0, fileName.find(".") );
-    ofstream outputFile( name + oper + ".txt" );
+        for ( auto & th : threads )
+            th.join();
 
-    for ( int i = 0; i < edgeList.size(); i++ ) {
-        outputFile << edgeList.at(i).src;
-        outputFile << " ";
-        outputFile << edgeList.at(i).dst;
-        outputFile << " \n";
+        for ( size_t i = 0; i < count; i++ ) {
+            cout << logs[i].str();
+            runKernels( reordered[i], source, job.kernels, orderings[first + i]->name() );
+        } // for
     } // for
-
-    outputFile.close();
-} // writeEdgeListFile
+} // runBatchJob
+
+void runBatch( int argc, char * argv[] ) {
+    for ( const BatchJob & job : parseArguments( argc, argv ) ) {
+        cout << "==================" << endl;
+        cout << job.fileName << endl;
+        auto start = chrono::steady_clock::now();
+        withGraph( job.fileName, [&]( const auto & graph ) {
+            auto end = chrono::steady_clock::now();
+            cout << "LoadGraph Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
+            runBatchJob( job, graph );
+        } );
+    } // for
+} // runBatch
 
 int getCommand() {
     cout << "==================" << endl;
@@ -415,6 +444,21 @@ int getCommand() {
     cout << "Degree Sort      3" << endl;
     cout << "HubCluster       4" << endl;
     cout << "graphAlgo        5" << endl;
+    cout << "CSR text export  6" << endl;
+    cout << "Rabbit Order     7" << endl;
+    cout << "Gorder           8" << endl;
+    cout << "RCM              9" << endl;
+    cout << "Hub Sort        10" << endl;
+    cout << "DBG             11" << endl;
+    cout << "Locality        12" << endl;
+    cout << "Cache Simulate  13" << endl;
+    cout << "Out-of-core     14" << endl;
+    cout << "Compressed CSR  15" << endl;
+    cout << "Binary edges    16" << endl;
+    cout << "Sort edge list  17" << endl;
+    cout << "Permutation     18" << endl;
+    cout << "Partition       19" << endl;
+    cout << "Segmented CSR   20" << endl;
     cout << "==================" << endl;
     cout << "Please input the command: ";
     int command = 0;
@@ -422,93 +466,448 @@ int getCommand() {
     return command;
 } // getCommand
 
-int main() {
+int main( int argc, char * argv[] ) {
+
+    if ( argc > 1 ) {
+        runBatch( argc, argv );
+        return 0;
+    } // if
 
     int command = getCommand();
-    int numOfNodes = 0;
-    vector<Edge> edgeList;
-    vector<int> csrOffsetArray, csrEdgeArray;
 
     cout << "Please input the file: ";
     string fileName = "";
     cin >> fileName;
 
-    srand(time(0));
-    clock_t start, end;
-
     // 把輸入圖一律變成 ID 從 0 開始
     if ( command == 0 ) {
-        init( fileName, edgeList );
+        init( fileName );
     } // if
 
     else if ( command == 1 ) {
-        readEdgeList( fileName, edgeList, numOfNodes );
+        EdgeList edgeList;
+        readEdgeList( fileName, edgeList );
+        auto convert = [&]( auto & graph ) {
+            buildCSR( edgeList, graph );
+            auto start = chrono::steady_clock::now();
+            printWriteCost( "WriteCSR", start, writeCSRBinaryFile( outputBaseName( fileName ) + "CSR.bin", graph ) );
+        };
+
+        if ( needsWideOffsets( edgeList.edges.size() ) ) {
+            CsrGraph64 graph;
+            convert( graph );
+        } // if
+        else {
+            CsrGraph graph;
+            convert( graph );
+        } // else
+    } // else if
 
-        start=clock();
-        convertToCSR( edgeList, csrOffsetArray, csrEdgeArray );
-        end=clock();
-        cout << "ConvertToCSR Time Cost: " << (1000.0)*(double)(end-start)/CLOCKS_PER_SEC << "ms" << endl;
+    else if ( command == 2 ) {
+        reorder( fileName, RandomOrder() );
+    } // else if
 
-        writeCSRFile( fileName, csrOffsetArray, csrEdgeArray );
+    else if ( command == 3 ) {
+        reorder( fileName, DegreeSort( getDegreeType() ) );
     } // else if
 
-    else if ( command == 2 ) {
-        readEdgeList( fileName, edgeList, numOfNodes );
+    else if ( command == 4 ) {
+        reorder( fileName, HubCluster( getDegreeType() ) );
+    } // else if
+
+    else if ( command == 5 ) {
+        // 二進位 CSR 直接 mmap，文字檔才需要解析
+        CsrGraph graph;
+        auto start = chrono::steady_clock::now();
+        loadCSR( fileName, graph );
+        auto end = chrono::steady_clock::now();
+        cout << "ReadCSR Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
+
+        int maxDegreeIndex = findMaxDegreeIndex( graph );
+
+        // 入邊的 CSR 給 bottom-up BFS 使用
+        CsrGraph inGraph;
+        start = chrono::steady_clock::now();
+        transposeCSR( graph, inGraph );
+        end = chrono::steady_clock::now();
+        cout << "TransposeCSR Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
 
-        start=clock();
-        randomOrder( edgeList, numOfNodes );
-        end=clock();
-        cout << "Random Time Cost: " << (1000.0)*(double)(end-start)/CLOCKS_PER_SEC << "ms" << endl;
+        // BFS
+        start = chrono::steady_clock::now();
+        vector<int> bfsTravelList = directionOptimizingBFS( graph, &inGraph, maxDegreeIndex );
+        end = chrono::steady_clock::now();
+        cout << "BFS Finish." << endl;
+        cout << "Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
 
-        writeEdgeListFile( fileName, edgeList, "_Random" );
+        // DFS
+        start = chrono::steady_clock::now();
+        vector<int> dfsTravelList = dfs( graph, maxDegreeIndex );
+        end = chrono::steady_clock::now();
+        cout << "DFS Finish." << endl;
+        cout << "Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
     } // else if
 
-    else if ( command == 3 ) {
-        readEdgeList( fileName, edgeList, numOfNodes );
+    // 文字格式的 CSR，供其他工具使用
+    else if ( command == 6 ) {
+        withGraph( fileName, [&]( const auto & graph ) {
+            auto start = chrono::steady_clock::now();
+            printWriteCost( "WriteCSR", start, writeCSRFile( fileName, graph ) );
+        } );
+    } // else if
 
-        start=clock();
-        degreeSort( edgeList, numOfNodes );
-        end=clock();
-        cout << "DegreeSort Time Cost: " << (1000.0)*(double)(end-start)/CLOCKS_PER_SEC << "ms" << endl;
+    else if ( command == 7 ) {
+        reorder( fileName, RabbitOrder() );
+    } // else if
 
-        writeEdgeListFile( fileName, edgeList, "_DegreeSort" );
+    else if ( command == 8 ) {
+        cout << "Please input the window size: ";
+        int window = 5;
+        cin >> window;
+        reorder( fileName, GOrder( window ) );
     } // else if
 
-    else if ( command == 4 ) {
-        readEdgeList( fileName, edgeList, numOfNodes );
+    else if ( command == 9 ) {
+        reorder( fileName, RCMOrder(), true );
+    } // else if
 
-        start=clock();
-        hubCluster( edgeList, numOfNodes );
-        end=clock();
-        cout << "HubCluster Time Cost: " << (1000.0)*(double)(end-start)/CLOCKS_PER_SEC << "ms" << endl;
+    else if ( command == 10 ) {
+        reorder( fileName, HubSort( getDegreeType() ) );
+    } // else if
 
-        writeEdgeListFile( fileName, edgeList, "_HubCluster" );
+    else if ( command == 11 ) {
+        reorder( fileName, DBG( getDegreeType() ) );
     } // else if
 
-    else if ( command == 5 ) {
-        vector<int> csrOffsetArray, csrEdgeArray;
-        readCSR( fileName, csrOffsetArray, csrEdgeArray );
+    // 量測某種 reordering 的區域性，不必真的套用；Original 表示目前的編號
+    else if ( command == 12 ) {
+        CsrGraph graph;
+        loadGraph( fileName, graph );
+
+        cout << "Please input the ordering ( Original for the current IDs ): ";
+        string name = "Original";
+        cin >> name;
+        unique_ptr<Ordering> ordering = makeOrdering( name );
+        if ( ordering == nullptr ) {
+            cout << "unknown ordering: " << name << endl;
+            return 0;
+        } // if
 
-        int maxDegreeIndex = findMaxDegreeIndex( csrOffsetArray );
+        Permutation permutation = ordering->compute( graph );
+        auto start = chrono::steady_clock::now();
+        LocalityMetrics metrics = localityMetrics( graph, &permutation );
+        auto end = chrono::steady_clock::now();
+        cout << "LocalityMetrics Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
+        printLocalityMetrics( metrics );
+    } // else if
 
-        start=clock();
-        // BFS
-        vector<int> bfsTravelList;
-        bfsTravelList = bfs( csrOffsetArray, csrEdgeArray, maxDegreeIndex );
-        end=clock();
-        cout << "BFS Finish." << endl;
-        cout << "Time Cost: " << (1000.0)*(double)(end-start)/CLOCKS_PER_SEC << "ms" << endl;
+    // 以 cache 模擬器評估 reordering：pull 與 push 各重播一輪
+    else if ( command == 13 ) {
+        CsrGraph graph;
+        loadGraph( fileName, graph );
+
+        cout << "Please input the ordering ( Original for the current IDs ): ";
+        string name = "Original";
+        cin >> name;
+        unique_ptr<Ordering> ordering = makeOrdering( name );
+        if ( ordering == nullptr ) {
+            cout << "unknown ordering: " << name << endl;
+            return 0;
+        } // if
 
-        start=clock();
-        // DFS
-        vector<int> dfsTravelList;
-        dfsTravelList = dfs( csrOffsetArray, csrEdgeArray, maxDegreeIndex );
-        end=clock();
-        cout << "DFS Finish." << endl;
-        cout << "Time Cost: " << (1000.0)*(double)(end-start)/CLOCKS_PER_SEC << "ms" << endl;
+        CacheConfig l1, l2;
+        cout << "Please input the cache ( size KB, associativity, line bytes ): ";
+        cin >> l1.sizeBytes >> l1.associativity >> l1.lineBytes;
+        l1.sizeBytes *= 1024;
+        // L2 大小為 0 時不模擬 L2，也不再詢問 associativity
+        cout << "Please input the L2 cache size KB ( 0 for none ): ";
+        l2.sizeBytes = 0;
+        cin >> l2.sizeBytes;
+        if ( l2.sizeBytes > 0 ) {
+            cout << "Please input the L2 cache associativity: ";
+            cin >> l2.associativity;
+        } // if
+        l2.sizeBytes *= 1024;
+        l2.lineBytes = l1.lineBytes;
+        const CacheConfig * second = l2.sizeBytes > 0 ? &l2 : nullptr;
+
+        CsrGraph reordered, inGraph;
+        applyPermutation( graph, ordering->compute( graph ), reordered );
+        transposeCSR( reordered, inGraph );
+
+        auto start = chrono::steady_clock::now();
+        CacheStats pullStats = simulateCache( inGraph, true, l1, second );
+        CacheStats pushStats = simulateCache( reordered, false, l1, second );
+        auto end = chrono::steady_clock::now();
+        cout << "CacheSimulate Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
+        printCacheStats( "Pull", pullStats, second != nullptr );
+        printCacheStats( "Push", pushStats, second != nullptr );
+    } // else if
+
+    // 圖放不進記憶體時：只保留 degree 陣列，邊分批排序寫到暫存檔再合併
+    else if ( command == 14 ) {
+        cout << "Please input the ordering ( 0: DegreeSort, 1: HubSort, 2: HubCluster, 3: DBG ): ";
+        int kind = 0;
+        cin >> kind;
+        DegreeType type = getDegreeType();
+        unique_ptr<DegreeOrdering> ordering;
+        if ( kind == 1 )
+            ordering.reset( new HubSort( type ) );
+        else if ( kind == 2 )
+            ordering.reset( new HubCluster( type ) );
+        else if ( kind == 3 )
+            ordering.reset( new DBG( type ) );
+        else
+            ordering.reset( new DegreeSort( type ) );
+
+        cout << "Please input the memory budget ( MB ): ";
+        size_t memoryMB = 1024;
+        cin >> memoryMB;
+        cout << "Please input the output format ( 0: edge list, 1: binary CSR ): ";
+        int format = 0;
+        cin >> format;
+
+        string outputName = outputBaseName( fileName ) + "_" + ordering->name() + ( format == 1 ? "CSR.bin" : ".txt" );
+        auto start = chrono::steady_clock::now();
+        outOfCoreReorder( fileName, *ordering, memoryMB << 20, outputName, format == 1,
+                          permutationFileName( fileName, "_" + ordering->name() ) );
+        auto end = chrono::steady_clock::now();
+        cout << "OutOfCore " << ordering->name() << " Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
     } // else if
+
+    // 壓縮的 CSR：比較大小，並直接在壓縮的圖上跑 BFS 與 PageRank
+    else if ( command == 15 ) {
+        CsrGraph graph;
+        loadGraph( fileName, graph );
+
+        cout << "Please input the format ( 0: varint, 1: bit-packed ): ";
+        int format = 0;
+        cin >> format;
+        CompressionFormat compression = format == 1 ? BITPACK_COMPRESSION : VARINT_COMPRESSION;
+
+        CsrGraph inGraph;
+        transposeCSR( graph, inGraph );
+        CompressedGraph compressed, compressedIn;
+        auto start = chrono::steady_clock::now();
+        compressCSR( graph, compression, compressed );
+        compressCSR( inGraph, compression, compressedIn );
+        auto end = chrono::steady_clock::now();
+        cout << "Compress Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
+
+        size_t csrBytes = ( graph.numOfNodes + 1 ) * sizeof( int ) + (size_t)graph.numOfEdges * sizeof( int );
+        cout << "CSR: " << csrBytes << " bytes, Compressed: " << compressed.bytes() << " bytes ( "
+             << ( graph.numOfEdges > 0 ? 8.0 * compressed.data.size() / graph.numOfEdges : 0 ) << " bits/edge )" << endl;
+
+        vector<int> outDegree( graph.numOfNodes );
+        for ( int v = 0; v < graph.numOfNodes; v++ )
+            outDegree[v] = graph.degree( v );
+
+        const int iterations = 10;
+        start = chrono::steady_clock::now();
+        vector<double> rank = pageRankPull( graph, inGraph, iterations );
+        end = chrono::steady_clock::now();
+        cout << "PageRank CSR Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
+        start = chrono::steady_clock::now();
+        vector<double> compressedRank = compressedPageRank( compressedIn, outDegree, iterations );
+        end = chrono::steady_clock::now();
+        cout << "PageRank Compressed Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
+
+        int source = 0;
+        for ( int v = 1; v < graph.numOfNodes; v++ )
+            if ( outDegree[v] > outDegree[source] )
+                source = v;
+        start = chrono::steady_clock::now();
+        vector<int> depth = compressedBFS( compressed, source );
+        end = chrono::steady_clock::now();
+        cout << "BFS Compressed Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
+
+        double maxDiff = 0;
+        for ( int v = 0; v < graph.numOfNodes; v++ )
+            maxDiff = max( maxDiff, fabs( rank[v] - compressedRank[v] ) );
+        int reached = count_if( depth.begin(), depth.end(), []( int d ) { return d >= 0; } );
+        cout << "PageRank max difference: " << maxDiff << ", BFS reached " << reached << " nodes" << endl;
+
+        writeCompressedFile( outputBaseName( fileName ) + ( format == 1 ? "_bitpackCSR.bin" : "_varintCSR.bin" ), compressed );
+    } // else if
+
+    // 二進位 edge list：每條邊兩個 u32 或 u64，比文字檔小、不需解析
+    else if ( command == 16 ) {
+        cout << "Please input the ID width ( 4 or 8 bytes ): ";
+        int idBytes = 4;
+        cin >> idBytes;
+        idBytes = idBytes == 8 ? 8 : 4;
+        withGraph( fileName, [&]( const auto & graph ) {
+            auto start = chrono::steady_clock::now();
+            printWriteCost( "WriteBinaryEdgeList", start,
+                            writeBinaryEdgeListFile( binaryEdgeListName( fileName, "", idBytes ), graph, idBytes ) );
+        } );
+    } // else if
+
+    // edge list 依 ( src, dst ) 排序，可去掉重複的邊，輸出 <name>_sorted.txt
+    else if ( command == 17 ) {
+        cout << "Please input whether to remove duplicate edges ( 0: keep, 1: remove ): ";
+        int removeDuplicates = 0;
+        cin >> removeDuplicates;
+
+        EdgeList edgeList;
+        readEdgeList( fileName, edgeList );
+        auto start = chrono::steady_clock::now();
+        size_t removed = sortEdgeList( edgeList, removeDuplicates == 1 );
+        auto end = chrono::steady_clock::now();
+        cout << "SortEdgeList Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
+        if ( removeDuplicates == 1 )
+            cout << "Removed " << removed << " duplicate edges" << endl;
+
+        start = chrono::steady_clock::now();
+        printWriteCost( "WriteEdgeList", start, writeEdgeListFile( fileName, edgeList, "_sorted" ) );
+    } // else if
+
+    // permutation 檔：依套用的順序合成多個 permutation，或把每個節點一筆的資料檔換成對應的編號
+    else if ( command == 18 ) {
+        cout << "Please input the operation ( 0: compose, 1: permute vertex data ): ";
+        int operation = 0;
+        cin >> operation;
+
+        if ( operation == 0 ) {
+            cout << "Please input the permutations applied after it ( files separated by ',' ): ";
+            string text = "";
+            cin >> text;
+            cout << "Please input the output file: ";
+            string outputName = "";
+            cin >> outputName;
+
+            Permutation composed, next;
+            loadPermutationFile( fileName, composed );
+            stringstream ss( text );
+            string name;
+            while ( getline( ss, name, ',' ) ) {
+                if ( name.empty() )
+                    continue;
+                loadPermutationFile( name, next );
+                composed = composePermutation( composed, next );
+            } // while
+
+            auto start = chrono::steady_clock::now();
+            printWriteCost( "WritePermutation", start, writePermutationFile( outputName, composed ) );
+        } // if
+        else {
+            cout << "Please input the vertex data file: ";
+            string dataName = "";
+            cin >> dataName;
+            cout << "Please input the record size and header size ( bytes ): ";
+            size_t recordBytes = 0, headerBytes = 0;
+            cin >> recordBytes >> headerBytes;
+            cout << "Please input the direction ( 0: original -> reordered, 1: reordered -> original ): ";
+            int direction = 0;
+            cin >> direction;
+
+            Permutation permutation;
+            vector<int> oldID;
+            loadPermutationFile( fileName, permutation, &oldID );
+            string outputName = outputBaseName( dataName ) + ( direction == 1 ? "_original.bin" : "_reordered.bin" );
+            auto start = chrono::steady_clock::now();
+            printWriteCost( "PermuteVertexData", start,
+                            permuteVertexData( dataName, outputName, direction == 1 ? permutation.newID : oldID, recordBytes, headerBytes ) );
+        } // else
+    } // else if
+
+    // 串流分割：每個 part 佔連續的 ID 區段，part 內再以另一個 reordering 編號，印出切割邊數與平衡度
+    else if ( command == 19 ) {
+        cout << "Please input the objective ( 0: LDG, 1: Fennel ): ";
+        int objective = 0;
+        cin >> objective;
+        cout << "Please input the number of parts and the balance slack ( e.g. 16 0.1 ): ";
+        int numParts = DEFAULT_NUM_PARTS;
+        double slack = DEFAULT_PARTITION_SLACK;
+        cin >> numParts >> slack;
+        PartitionObjective partitionObjective = objective == 1 ? FENNEL_PARTITION : LDG_PARTITION;
+
+        // 串流模式直接讀依 src 分組的 edge list，不建 CSR，只輸出 part 連續（part 內維持原 ID 順序）的 permutation 檔
+        cout << "Please input the input mode ( 0: load the graph, 1: stream the edge list grouped by source ): ";
+        int mode = 0;
+        cin >> mode;
+        if ( mode == 1 ) {
+            string name = objective == 1 ? "Fennel" : "LDG";
+            auto start = chrono::steady_clock::now();
+            vector<int> part = streamingPartitionEdgeList( fileName, numParts, partitionObjective, slack );
+            auto end = chrono::steady_clock::now();
+            cout << name << " Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
+            printPartitionStats( partitionStatsEdgeList( fileName, part, max( 1, numParts ) ) );
+
+            start = chrono::steady_clock::now();
+            printWriteCost( "WritePermutation", start,
+                            writePermutationFile( permutationFileName( fileName, "_" + name ),
+                                                  partitionContiguousOrder( part, max( 1, numParts ) ) ) );
+            return 0;
+        } // if
+
+        cout << "Please input the ordering inside each part ( Original to keep the IDs ): ";
+        string innerName = "bfsOrderAll";
+        cin >> innerName;
+        shared_ptr<const Ordering> inner = makeOrdering( innerName );
+        if ( inner == nullptr ) {
+            cout << "unknown ordering: " << innerName << endl;
+            return 0;
+        } // if
+
+        CsrGraph graph;
+        loadGraph( fileName, graph );
+        PartitionOrder ordering( partitionObjective, numParts, slack, inner );
+
+        auto start = chrono::steady_clock::now();
+        vector<int> part = ordering.partition( graph );
+        auto end = chrono::steady_clock::now();
+        cout << ordering.name() << " Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
+        printPartitionStats( partitionStats( graph, part, ordering.parts() ) );
+
+        start = chrono::steady_clock::now();
+        Permutation permutation = ordering.order( graph, part );
+        end = chrono::steady_clock::now();
+        cout << inner->name() << " Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
+
+        CsrGraph reordered;
+        writeReorderedGraph( fileName, ordering.name(), graph, permutation, reordered );
+    } // else if
+
+    // 分段的 CSR：來源節點依 LLC 大小分段，比較一般的 pull PageRank 與分段的 PageRank
+    else if ( command == 20 ) {
+        cout << "Please input the LLC size ( KB, 0 for detected ): ";
+        size_t llcKB = 0;
+        cin >> llcKB;
+        size_t llcBytes = llcKB > 0 ? min<size_t>( llcKB, SIZE_MAX >> 10 ) << 10 : lastLevelCacheBytes();
+
+        CsrGraph graph, inGraph;
+        loadGraph( fileName, graph );
+        transposeCSR( graph, inGraph );
+
+        SegmentedGraph segmented;
+        auto start = chrono::steady_clock::now();
+        segmentCSR( inGraph, segmentSizeFor( llcBytes ), segmented );
+        auto end = chrono::steady_clock::now();
+        cout << "SegmentCSR Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
+        cout << "Segments: " << segmented.numSegments << " x " << segmented.segmentSize << " nodes, Rows: " << segmented.numRows()
+             << " ( " << ( graph.numOfNodes > 0 ? (double)segmented.numRows() / graph.numOfNodes : 0 ) << " per node )" << endl;
+
+        vector<int> outDegree = segmentedOutDegree( segmented );
+        const int iterations = 10;
+        start = chrono::steady_clock::now();
+        vector<double> rank = pageRankPull( graph, inGraph, iterations );
+        end = chrono::steady_clock::now();
+        cout << "PageRank CSR Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
+        start = chrono::steady_clock::now();
+        vector<double> segmentedRank = segmentedPageRank( segmented, outDegree, iterations );
+        end = chrono::steady_clock::now();
+        cout << "PageRank Segmented Time Cost: " << chrono::duration<double, milli>( end - start ).count() << "ms" << endl;
+
+        double maxDiff = 0;
+        for ( int v = 0; v < graph.numOfNodes; v++ )
+            maxDiff = max( maxDiff, fabs( rank[v] - segmentedRank[v] ) );
+        cout << "PageRank max difference: " << maxDiff << endl;
+
+        writeSegmentedFile( outputBaseName( fileName ) + "_segmentedCSR.bin", segmented );
+    } // else if
+
     else {
         cout << "command error!";
     } // else
 
-} // main()
+} // main()
\ No newline at end of file
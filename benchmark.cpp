@@ -0,0 +1,209 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+
+#include "graph.h"
+#include "graphIO.h"
+#include "kernels.h"
+#include "orderings.h"
+#include "parallel.h"
+#include "traversal.h"
+
+using namespace std;
+
+const int PAGERANK_ITERATIONS = 20;
+const int SSSP_DELTA = 32;
+
+// 一個 ( reordering, kernel ) 的量測結果
+struct BenchmarkResult {
+    string ordering;
+    string kernel;
+    double orderingTime;    // 算 permutation 的時間（ms）
+    double medianTime;      // kernel 的中位數時間（ms）
+    double edgesPerSecond;
+    double speedup;         // 相對於 Original 的加速比
+    long long check;        // 結果摘要，不同 reordering 應該相同（PageRank 除外）
+};
+
+// 執行 trials 次，回傳中位數時間（ms）
+double medianTime( int trials, const function<void()> & run ) {
+    vector<double> times;
+    for ( int t = 0; t < trials; t++ ) {
+        auto start = chrono::steady_clock::now();
+        run();
+        auto end = chrono::steady_clock::now();
+        times.push_back( chrono::duration<double, milli>( end - start ).count() );
+    } // for
+
+    sort( times.begin(), times.end() );
+    int n = times.size();
+    return n % 2 == 1 ? times[n / 2] : ( times[n / 2 - 1] + times[n / 2] ) / 2;
+} // medianTime
+
+// 以逗號分隔的名稱，"all" 表示全部；Original 一定放在第一個當作基準
+vector<string> parseOrderings( const string & text ) {
+    vector<string> names;
+    if ( text == "all" )
+        names = orderingNames();
+    else {
+        stringstream ss( text );
+        string name;
+        while ( getline( ss, name, ',' ) ) {
+            if ( !name.empty() )
+                names.push_back( name );
+        } // while
+    } // else
+
+    names.erase( remove( names.begin(), names.end(), "Original" ), names.end() );
+    names.insert( names.begin(), "Original" );
+    return names;
+} // parseOrderings
+
+// 對一種 reordering 跑所有 kernel：出邊、入邊與無向圖都由原圖以同一個 permutation 換成新編號
+void benchmarkOrdering( const BidirectionalGraph & original, const CsrGraph & originalUndirected, const Ordering & ordering,
+                        int source, int trials, vector<BenchmarkResult> & results ) {
+    auto start = chrono::steady_clock::now();
+    Permutation permutation = ordering.compute( original.out );
+    auto end = chrono::steady_clock::now();
+    double orderingTime = chrono::duration<double, milli>( end - start ).count();
+
+    BidirectionalGraph reordered;
+    CsrGraph undirected;
+    applyPermutation( original, permutation, reordered );
+    applyPermutation( originalUndirected, permutation, undirected );
+    const CsrGraph & graph = reordered.out;
+    const CsrGraph & inGraph = reordered.in;
+
+    // 權重依原始 ID 計算
+    vector<int> weight = originalEdgeWeights( graph, inversePermutation( permutation ) );
+
+    int newSource = source >= 0 ? permutation.newID[source] : -1;
+    auto record = [&]( const string & kernel, double time, double edges, long long check ) {
+        results.push_back( { ordering.name(), kernel, orderingTime, time, time > 0 ? edges / ( time / 1000 ) : 0, 0, check } );
+        cout << ordering.name() << " " << kernel << " Time Cost: " << time << "ms" << endl;
+    };
+
+    double time = medianTime( trials, [&]() { pageRankPull( graph, inGraph, PAGERANK_ITERATIONS ); } );
+    record( "PageRankPull", time, (double)graph.numOfEdges * PAGERANK_ITERATIONS, PAGERANK_ITERATIONS );
+
+    time = medianTime( trials, [&]() { pageRankPush( graph, PAGERANK_ITERATIONS ); } );
+    record( "PageRankPush", time, (double)graph.numOfEdges * PAGERANK_ITERATIONS, PAGERANK_ITERATIONS );
+
+    vector<int> dist;
+    time = medianTime( trials, [&]() { dist = deltaSteppingSSSP( graph, weight, newSource, SSSP_DELTA ); } );
+    long long distSum = 0;
+    for ( int d : dist ) {
+        if ( d != INT_MAX )
+            distSum += d;
+    } // for
+    record( "SSSP", time, graph.numOfEdges, distSum );
+
+    vector<int> label;
+    int iterations = 0;
+    time = medianTime( trials, [&]() { label = labelPropagationCC( undirected, iterations ); } );
+    long long numComponents = 0;
+    for ( int v = 0; v < undirected.numOfNodes; v++ ) {
+        if ( label[v] == v )
+            numComponents++;
+    } // for
+    record( "CC", time, (double)undirected.numOfEdges * iterations, numComponents );
+
+    vector<int> order;
+    time = medianTime( trials, [&]() { order = directionOptimizingBFS( graph, &inGraph, newSource ); } );
+    record( "BFS", time, graph.numOfEdges, order.size() );
+} // benchmarkOrdering
+
+void writeCSV( const string & fileName, const vector<BenchmarkResult> & results ) {
+    ofstream outputFile( fileName );
+    outputFile << "ordering,kernel,ordering_ms,median_ms,edges_per_sec,speedup,check\n";
+    for ( const BenchmarkResult & r : results ) {
+        outputFile << r.ordering << "," << r.kernel << "," << r.orderingTime << "," << r.medianTime << ","
+                   << r.edgesPerSecond << "," << r.speedup << "," << r.check << "\n";
+    } // for
+
+    outputFile.close();
+} // writeCSV
+
+void writeJSON( const string & fileName, const vector<BenchmarkResult> & results ) {
+    ofstream outputFile( fileName );
+    outputFile << "[\n";
+    for ( size_t i = 0; i < results.size(); i++ ) {
+        const BenchmarkResult & r = results[i];
+        outputFile << "  { \"ordering\": \"" << r.ordering << "\", \"kernel\": \"" << r.kernel
+                   << "\", \"ordering_ms\": " << r.orderingTime << ", \"median_ms\": " << r.medianTime
+                   << ", \"edges_per_sec\": " << r.edgesPerSecond << ", \"speedup\": " << r.speedup
+                   << ", \"check\": " << r.check << " }" << ( i + 1 < results.size() ? "," : "" ) << "\n";
+    } // for
+
+    outputFile << "]\n";
+    outputFile.close();
+} // writeJSON
+
+int main() {
+
+    cout << "Please input the file: ";
+    string fileName = "";
+    cin >> fileName;
+
+    cout << "Please input the number of trials: ";
+    int trials = 3;
+    cin >> trials;
+    trials = max( trials, 1 );
+
+    cout << "Please input the orderings ( names separated by ',', all for every ordering ): ";
+    string orderingText = "all";
+    cin >> orderingText;
+
+    cout << "Please input the output format ( 0: CSV, 1: JSON ): ";
+    int format = 0;
+    cin >> format;
+
+    CsrGraph graph;
+    loadGraph( fileName, graph );
+
+    // BFS / SSSP 從原圖 out-degree 最大的節點出發，各 reordering 換成對應的新 ID
+    int source = -1;
+    for ( int v = 0; v < graph.numOfNodes; v++ ) {
+        if ( source == -1 || graph.degree( v ) > graph.degree( source ) )
+            source = v;
+    } // for
+
+    // 出邊、入邊與無向圖只在原圖上建一次
+    BidirectionalGraph original;
+    CsrGraph undirected;
+    buildBidirectionalGraph( move( graph ), original );
+    symmetrizeCSR( original.out, original.in, undirected );
+
+    vector<BenchmarkResult> results;
+    for ( const string & name : parseOrderings( orderingText ) ) {
+        unique_ptr<Ordering> ordering = makeOrdering( name );
+        if ( ordering == nullptr ) {
+            cout << "unknown ordering: " << name << endl;
+            continue;
+        } // if
+
+        benchmarkOrdering( original, undirected, *ordering, source, trials, results );
+    } // for
+
+    // 加速比：同一個 kernel 在 Original 下的時間 / 這個 reordering 的時間
+    for ( BenchmarkResult & r : results ) {
+        for ( const BenchmarkResult & base : results ) {
+            if ( base.ordering == "Original" && base.kernel == r.kernel && r.medianTime > 0 )
+                r.speedup = base.medianTime / r.medianTime;
+        } // for
+    } // for
+
+    string outputName = outputBaseName( fileName ) + "_benchmark" + ( format == 1 ? ".json" : ".csv" );
+    if ( format == 1 )
+        writeJSON( outputName, results );
+    else
+        writeCSV( outputName, results );
+
+    cout << "benchmark finish!" << endl;
+
+} // main()
\ No newline at end of file
@@ -0,0 +1,161 @@
+#ifndef CACHE_SIM_H
+#define CACHE_SIM_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "graph.h"
+#include "parallel.h"
+
+using namespace std;
+
+// ---------------------------------------- cache 模擬器
+// 沒有硬體 counter 時用來評估 reordering：重播一輪 CSR pull / push 的記憶體存取，
+// 經過 set-associative、LRU 的 cache（可再接一層 L2），統計 miss rate。
+// 存取的陣列：offsets、edges（4 bytes）、來源與目的端的節點屬性（8 bytes，例如 PageRank 的 double）。
+// 節點依 ID 切成 numShards 段並行模擬，每段有自己的 cache（冷啟動），
+// 段數固定時結果與執行緒數量無關；段數為 1 時就是完整的循序模擬。
+
+struct CacheConfig {
+    long long sizeBytes = 32 * 1024;
+    int associativity = 8;
+    int lineBytes = 64;
+};
+
+struct CacheStats {
+    long long accesses = 0;
+    long long misses = 0;
+    long long propertyAccesses = 0;     // 節點屬性的存取
+    long long propertyMisses = 0;
+    long long l2Accesses = 0;           // 即 L1 的 miss
+    long long l2Misses = 0;
+
+    double missRate() const { return accesses > 0 ? (double)misses / accesses : 0; }
+    double propertyMissRate() const { return propertyAccesses > 0 ? (double)propertyMisses / propertyAccesses : 0; }
+    double l2MissRate() const { return l2Accesses > 0 ? (double)l2Misses / l2Accesses : 0; }
+};
+
+// 一層 set-associative LRU cache
+class CacheLevel {
+public:
+    explicit CacheLevel( const CacheConfig & config ) {
+        lineShift = 0;
+        while ( ( 1 << ( lineShift + 1 ) ) <= config.lineBytes )
+            lineShift++;
+        ways = max( 1, config.associativity );
+        numSets = max<long long>( 1, config.sizeBytes / ( (long long)ways << lineShift ) );
+        tags.assign( numSets * ways, UINT64_MAX );
+        stamps.assign( numSets * ways, 0 );
+        clock = 0;
+    } // CacheLevel
+
+    // 存取 address，回傳是否命中；miss 時換掉最久沒用的 line
+    bool access( uint64_t address ) {
+        uint64_t line = address >> lineShift;
+        size_t base = ( line % numSets ) * ways;
+        clock++;
+
+        size_t victim = base;
+        for ( size_t w = base; w < base + ways; w++ ) {
+            if ( tags[w] == line ) {
+                stamps[w] = clock;
+                return true;
+            } // if
+            if ( stamps[w] < stamps[victim] )
+                victim = w;
+        } // for
+
+        tags[victim] = line;
+        stamps[victim] = clock;
+        return false;
+    } // access
+
+private:
+    int lineShift;
+    int ways;
+    long long numSets;
+    vector<uint64_t> tags;
+    vector<uint64_t> stamps;
+    uint64_t clock;
+};
+
+// 重播 graph 一輪的存取：
+//   pull : v 依序讀入鄰居 u 的屬性（source[u]），最後寫 target[v]；graph 應為入邊 CSR
+//   push : u 讀 source[u] 一次，再把值寫到每個出鄰居的 target[v]
+// l2 為 nullptr 時只有一層
+inline CacheStats simulateCache( const CsrGraph & graph, bool pull, const CacheConfig & l1,
+                                 const CacheConfig * l2 = nullptr, int numShards = 64 ) {
+    int numNodes = graph.numOfNodes;
+    numShards = max( 1, min( numShards, numNodes ) );
+
+    // 各陣列的起始位址，彼此以 4KB 對齊隔開
+    auto alignPage = []( uint64_t pos ) { return ( pos + 4095 ) & ~(uint64_t)4095; };
+    uint64_t offsetBase = 0;
+    uint64_t edgeBase = alignPage( offsetBase + 4ULL * ( numNodes + 1 ) );
+    uint64_t sourceBase = alignPage( edgeBase + 4ULL * graph.numOfEdges );
+    uint64_t targetBase = alignPage( sourceBase + 8ULL * numNodes );
+
+    vector<CacheStats> shardStats( numShards );
+    parallelForDynamic( 0, numShards, 1, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t s = lo; s < hi; s++ ) {
+            CacheLevel first( l1 );
+            vector<CacheLevel> second;
+            if ( l2 != nullptr )
+                second.emplace_back( *l2 );
+
+            CacheStats & stats = shardStats[s];
+            auto touch = [&]( uint64_t address, bool property ) {
+                stats.accesses++;
+                if ( property )
+                    stats.propertyAccesses++;
+                if ( first.access( address ) )
+                    return;
+
+                stats.misses++;
+                if ( property )
+                    stats.propertyMisses++;
+                if ( !second.empty() ) {
+                    stats.l2Accesses++;
+                    if ( !second[0].access( address ) )
+                        stats.l2Misses++;
+                } // if
+            };
+
+            int firstNode = (long long)numNodes * s / numShards;
+            int lastNode = (long long)numNodes * ( s + 1 ) / numShards;
+            for ( int v = firstNode; v < lastNode; v++ ) {
+                touch( offsetBase + 4ULL * v, false );
+                touch( offsetBase + 4ULL * ( v + 1 ), false );
+                if ( !pull )
+                    touch( sourceBase + 8ULL * v, true );
+
+                for ( int e = graph.offsets[v]; e < graph.offsets[v + 1]; e++ ) {
+                    touch( edgeBase + 4ULL * e, false );
+                    int neighbor = graph.edges[e];
+                    if ( pull )
+                        touch( sourceBase + 8ULL * neighbor, true );
+                    else
+                        touch( targetBase + 8ULL * neighbor, true );
+                } // for
+
+                if ( pull )
+                    touch( targetBase + 8ULL * v, true );
+            } // for
+        } // for
+    } );
+
+    CacheStats total;
+    for ( const CacheStats & stats : shardStats ) {
+        total.accesses += stats.accesses;
+        total.misses += stats.misses;
+        total.propertyAccesses += stats.propertyAccesses;
+        total.propertyMisses += stats.propertyMisses;
+        total.l2Accesses += stats.l2Accesses;
+        total.l2Misses += stats.l2Misses;
+    } // for
+
+    return total;
+} // simulateCache
+
+#endif // CACHE_SIM_H
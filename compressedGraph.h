@@ -0,0 +1,527 @@
+#ifndef COMPRESSED_GRAPH_H
+#define COMPRESSED_GRAPH_H
+
+#include <iostream>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined( __SSE2__ )
+#include <emmintrin.h>
+#endif
+
+#include "graph.h"
+#include "kernels.h"
+#include "parallel.h"
+
+using namespace std;
+
+// ---------------------------------------- 壓縮的 CSR
+// 每列的鄰居排序後存成差值（reordering 後鄰居 ID 接近，差值小），兩種格式：
+//   VARINT_COMPRESSION  : degree、第一個鄰居與列 ID 的差（zigzag）、之後每個差值，皆為 varint
+//   BITPACK_COMPRESSION : degree、第一個鄰居（同上），再一個 byte 的位元寬度 b，
+//                         其餘差值每個 b 位元，分成 4 個 lane 垂直排列：第 k 個差值放在 lane k % 4，
+//                         lane 之間的 32 位元 word 交錯存放，因此 SSE2 可以一次解出 4 個
+// rowStart[v] 為第 v 列在 data 中的位置；data 尾端多留 16 bytes，SIMD 讀取不會越界。
+// 沒有 SSE2 時使用結果相同的純量解碼。
+
+enum CompressionFormat {
+    VARINT_COMPRESSION,
+    BITPACK_COMPRESSION
+};
+
+const int COMPRESSED_PADDING = 16;
+
+inline uint32_t zigzagEncode( int value ) {
+    return ( (uint32_t)value << 1 ) ^ (uint32_t)( value >> 31 );
+} // zigzagEncode
+
+inline int zigzagDecode( uint32_t value ) {
+    return (int)( value >> 1 ) ^ -(int)( value & 1 );
+} // zigzagDecode
+
+// 寫一個 varint，out 為 nullptr 時只計算長度；回傳寫入的 byte 數
+inline size_t writeVarint( uint32_t value, uint8_t * out ) {
+    size_t length = 0;
+    while ( value >= 0x80 ) {
+        if ( out != nullptr )
+            out[length] = ( value & 0x7F ) | 0x80;
+        value >>= 7;
+        length++;
+    } // while
+
+    if ( out != nullptr )
+        out[length] = value;
+    return length + 1;
+} // writeVarint
+
+inline uint32_t readVarint( const uint8_t * & p ) {
+    uint32_t value = *p & 0x7F;
+    int shift = 7;
+    while ( *p++ & 0x80 ) {
+        value |= (uint32_t)( *p & 0x7F ) << shift;
+        shift += 7;
+    } // while
+
+    return value;
+} // readVarint
+
+// 以 bits 位元存 count 個值時，每個 lane 需要的 word 數
+inline size_t packedWordsPerLane( size_t count, int bits ) {
+    size_t perLane = ( count + 3 ) / 4;
+    return ( perLane * bits + 31 ) / 32;
+} // packedWordsPerLane
+
+struct CompressedGraph {
+    CompressionFormat format = VARINT_COMPRESSION;
+    int numOfNodes = 0;
+    uint64_t numOfEdges = 0;          // 可超過 int 範圍（由 CsrGraph64 壓縮時）
+    vector<uint64_t> rowStart;      // 長度 numOfNodes + 1
+    vector<uint8_t> data;
+
+    int degree( int node ) const {
+        const uint8_t * p = data.data() + rowStart[node];
+        return readVarint( p );
+    } // degree
+
+    // 解出第 node 列的鄰居（由小到大）到 out，回傳數量；out 至少要有 degree + 3 個空間
+    int decodeRow( int node, int * out ) const {
+        const uint8_t * p = data.data() + rowStart[node];
+        int degree = readVarint( p );
+        if ( degree == 0 )
+            return 0;
+
+        int previous = node + zigzagDecode( readVarint( p ) );
+        out[0] = previous;
+        if ( format == VARINT_COMPRESSION )
+            decodeVarintGaps( p, degree - 1, previous, out + 1 );
+        else {
+            int bits = *p++;
+            decodePackedGaps( p, degree - 1, bits, previous, out + 1 );
+        } // else
+
+        return degree;
+    } // decodeRow
+
+    // 記憶體用量（bytes）
+    size_t bytes() const {
+        return rowStart.size() * sizeof( uint64_t ) + data.size();
+    } // bytes
+
+private:
+    // 差值皆小於 128（每個 1 byte）時，SSE2 一次處理 16 個
+    static void decodeVarintGaps( const uint8_t * p, int count, int previous, int * out ) {
+        int i = 0;
+#if defined( __SSE2__ )
+        __m128i zero = _mm_setzero_si128();
+        while ( i + 16 <= count ) {
+            __m128i bytes = _mm_loadu_si128( reinterpret_cast<const __m128i *>( p ) );
+            if ( _mm_movemask_epi8( bytes ) != 0 )
+                break;
+
+            __m128i low = _mm_unpacklo_epi8( bytes, zero );
+            __m128i high = _mm_unpackhi_epi8( bytes, zero );
+            __m128i gaps[4] = { _mm_unpacklo_epi16( low, zero ), _mm_unpackhi_epi16( low, zero ),
+                                _mm_unpacklo_epi16( high, zero ), _mm_unpackhi_epi16( high, zero ) };
+            __m128i carry = _mm_set1_epi32( previous );
+            for ( int k = 0; k < 4; k++ ) {
+                __m128i x = gaps[k];
+                x = _mm_add_epi32( x, _mm_slli_si128( x, 4 ) );
+                x = _mm_add_epi32( x, _mm_slli_si128( x, 8 ) );
+                x = _mm_add_epi32( x, carry );
+                _mm_storeu_si128( reinterpret_cast<__m128i *>( out + i + 4 * k ), x );
+                carry = _mm_shuffle_epi32( x, 0xFF );
+            } // for
+
+            previous = out[i + 15];
+            p += 16;
+            i += 16;
+        } // while
+#endif
+
+        for ( ; i < count; i++ ) {
+            previous += readVarint( p );
+            out[i] = previous;
+        } // for
+    } // decodeVarintGaps
+
+    // 垂直排列的 bit-packing：4 個 lane 的位元位置相同，一次解出 4 個差值再做前綴和
+    static void decodePackedGaps( const uint8_t * p, int count, int bits, int previous, int * out ) {
+        size_t perLane = ( count + 3 ) / 4;
+        if ( bits == 0 ) {
+            for ( int i = 0; i < count; i++ )
+                out[i] = previous;
+            return;
+        } // if
+
+        uint32_t mask = bits == 32 ? 0xFFFFFFFFu : ( ( 1u << bits ) - 1 );
+#if defined( __SSE2__ )
+        const __m128i * words = reinterpret_cast<const __m128i *>( p );
+        __m128i maskVector = _mm_set1_epi32( mask );
+        __m128i carry = _mm_set1_epi32( previous );
+        __m128i current = _mm_loadu_si128( words );
+        int word = 0, offset = 0;
+        for ( size_t j = 0; j < perLane; j++ ) {
+            __m128i value = _mm_srl_epi32( current, _mm_cvtsi32_si128( offset ) );
+            offset += bits;
+            if ( offset >= 32 ) {
+                offset -= 32;
+                word++;
+                current = _mm_loadu_si128( words + word );
+                if ( offset > 0 )
+                    value = _mm_or_si128( value, _mm_sll_epi32( current, _mm_cvtsi32_si128( bits - offset ) ) );
+            } // if
+
+            __m128i x = _mm_and_si128( value, maskVector );
+            x = _mm_add_epi32( x, _mm_slli_si128( x, 4 ) );
+            x = _mm_add_epi32( x, _mm_slli_si128( x, 8 ) );
+            x = _mm_add_epi32( x, carry );
+            _mm_storeu_si128( reinterpret_cast<__m128i *>( out + 4 * j ), x );
+            carry = _mm_shuffle_epi32( x, 0xFF );
+        } // for
+#else
+        for ( size_t j = 0; j < perLane; j++ ) {
+            size_t bit = j * bits;
+            for ( int lane = 0; lane < 4; lane++ ) {
+                uint32_t low, high = 0;
+                memcpy( &low, p + 4 * ( 4 * ( bit / 32 ) + lane ), 4 );
+                if ( bit % 32 + bits > 32 )
+                    memcpy( &high, p + 4 * ( 4 * ( bit / 32 + 1 ) + lane ), 4 );
+                uint64_t combined = ( (uint64_t)high << 32 ) | low;
+                previous += ( combined >> ( bit % 32 ) ) & mask;
+                out[4 * j + lane] = previous;
+            } // for
+        } // for
+#endif
+    } // decodePackedGaps
+};
+
+// 編碼一列（neighbors 已排序），out 為 nullptr 時只計算長度；回傳 byte 數
+inline size_t encodeRow( CompressionFormat format, int node, const int * neighbors, int degree, uint8_t * out ) {
+    size_t length = writeVarint( degree, out );
+    if ( degree == 0 )
+        return length;
+
+    length += writeVarint( zigzagEncode( neighbors[0] - node ), out != nullptr ? out + length : nullptr );
+    if ( format == VARINT_COMPRESSION ) {
+        for ( int i = 1; i < degree; i++ )
+            length += writeVarint( neighbors[i] - neighbors[i - 1], out != nullptr ? out + length : nullptr );
+        return length;
+    } // if
+
+    uint32_t maxGap = 0;
+    for ( int i = 1; i < degree; i++ )
+        maxGap = max<uint32_t>( maxGap, neighbors[i] - neighbors[i - 1] );
+    int bits = 0;
+    while ( bits < 32 && ( maxGap >> bits ) != 0 )
+        bits++;
+
+    size_t count = degree - 1;
+    size_t numWords = 4 * packedWordsPerLane( count, bits );
+    if ( out != nullptr ) {
+        // out 由 compressCSR 預先清為 0，這裡只把各差值 OR 進對應的 word
+        out[length] = bits;
+        uint8_t * packed = out + length + 1;
+        auto orWord = [&]( size_t index, uint32_t value ) {
+            uint32_t word;
+            memcpy( &word, packed + 4 * index, 4 );
+            word |= value;
+            memcpy( packed + 4 * index, &word, 4 );
+        };
+
+        for ( size_t k = 0; bits > 0 && k < count; k++ ) {
+            uint64_t gap = (uint32_t)( neighbors[k + 1] - neighbors[k] );
+            size_t bit = ( k / 4 ) * bits;
+            size_t lane = k % 4;
+            orWord( 4 * ( bit / 32 ) + lane, (uint32_t)( gap << ( bit % 32 ) ) );
+            if ( bit % 32 + bits > 32 )
+                orWord( 4 * ( bit / 32 + 1 ) + lane, (uint32_t)( gap >> ( 32 - bit % 32 ) ) );
+        } // for
+    } // if
+
+    return length + 1 + numWords * sizeof( uint32_t );
+} // encodeRow
+
+// 把 CSR 壓縮（並行）：第一輪算每列長度，前綴和後第二輪寫入；CsrGraph64 也適用（rowStart 為 64 位元）
+template <class EdgeID>
+void compressCSR( const BasicCsrGraph<int, EdgeID> & graph, CompressionFormat format, CompressedGraph & compressed ) {
+    int numNodes = graph.numOfNodes;
+    compressed.format = format;
+    compressed.numOfNodes = numNodes;
+    compressed.numOfEdges = graph.numOfEdges;
+    compressed.rowStart.assign( numNodes + 1, 0 );
+
+    auto sortedRow = [&]( int v, vector<int> & row ) {
+        row.assign( graph.edges + graph.offsets[v], graph.edges + graph.offsets[v + 1] );
+        if ( !is_sorted( row.begin(), row.end() ) )
+            sort( row.begin(), row.end() );
+    };
+
+    parallelForDynamic( 0, numNodes, 1024, [&]( int, size_t lo, size_t hi ) {
+        vector<int> row;
+        for ( size_t v = lo; v < hi; v++ ) {
+            sortedRow( v, row );
+            compressed.rowStart[v + 1] = encodeRow( format, v, row.data(), row.size(), nullptr );
+        } // for
+    } );
+
+    for ( int v = 1; v <= numNodes; v++ )
+        compressed.rowStart[v] += compressed.rowStart[v - 1];
+
+    compressed.data.assign( compressed.rowStart[numNodes] + COMPRESSED_PADDING, 0 );
+    parallelForDynamic( 0, numNodes, 1024, [&]( int, size_t lo, size_t hi ) {
+        vector<int> row;
+        for ( size_t v = lo; v < hi; v++ ) {
+            sortedRow( v, row );
+            encodeRow( format, v, row.data(), row.size(), compressed.data.data() + compressed.rowStart[v] );
+        } // for
+    } );
+} // compressCSR
+
+// 最大 degree，決定解碼緩衝區大小
+inline int maxCompressedDegree( const CompressedGraph & graph ) {
+    vector<int> threadMax( numOfThreads(), 0 );
+    parallelFor( 0, graph.numOfNodes, [&]( int tid, size_t lo, size_t hi ) {
+        int localMax = 0;
+        for ( size_t v = lo; v < hi; v++ )
+            localMax = max( localMax, graph.degree( v ) );
+        threadMax[tid] = localMax;
+    } );
+
+    return *max_element( threadMax.begin(), threadMax.end() );
+} // maxCompressedDegree
+
+// 直接在壓縮的圖上做 top-down BFS，回傳每個節點的層數，無法到達為 -1
+inline vector<int> compressedBFS( const CompressedGraph & graph, int source ) {
+    int numNodes = graph.numOfNodes;
+    unique_ptr<atomic<int>[]> depth( new atomic<int>[numNodes] );
+    parallelFor( 0, numNodes, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t v = lo; v < hi; v++ )
+            depth[v].store( -1, memory_order_relaxed );
+    } );
+
+    vector<int> frontier;
+    if ( source >= 0 && source < numNodes ) {
+        depth[source].store( 0, memory_order_relaxed );
+        frontier.push_back( source );
+    } // if
+
+    int bufferSize = maxCompressedDegree( graph ) + 4;
+    vector<vector<int>> threadNext( numOfThreads() );
+    for ( int level = 1; !frontier.empty(); level++ ) {
+        parallelForDynamic( 0, frontier.size(), 64, [&]( int tid, size_t lo, size_t hi ) {
+            vector<int> neighbors( bufferSize );
+            for ( size_t i = lo; i < hi; i++ ) {
+                int degree = graph.decodeRow( frontier[i], neighbors.data() );
+                for ( int k = 0; k < degree; k++ ) {
+                    int expected = -1;
+                    if ( depth[neighbors[k]].load( memory_order_relaxed ) == -1 &&
+                         depth[neighbors[k]].compare_exchange_strong( expected, level, memory_order_relaxed ) )
+                        threadNext[tid].push_back( neighbors[k] );
+                } // for
+            } // for
+        } );
+
+        frontier.clear();
+        for ( auto & next : threadNext ) {
+            frontier.insert( frontier.end(), next.begin(), next.end() );
+            next.clear();
+        } // for
+    } // for
+
+    vector<int> result( numNodes );
+    parallelFor( 0, numNodes, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t v = lo; v < hi; v++ )
+            result[v] = depth[v].load( memory_order_relaxed );
+    } );
+
+    return result;
+} // compressedBFS
+
+// 直接在壓縮的入邊圖上做 pull PageRank；outDegree 為原圖的 out-degree
+inline vector<double> compressedPageRank( const CompressedGraph & inGraph, const vector<int> & outDegree,
+                                          int iterations ) {
+    int numNodes = inGraph.numOfNodes;
+    double base = ( 1.0 - PAGERANK_DAMPING ) / max( numNodes, 1 );
+    vector<double> rank( numNodes, 1.0 / max( numNodes, 1 ) );
+    vector<double> contribution( numNodes );
+    int bufferSize = maxCompressedDegree( inGraph ) + 4;
+
+    for ( int iter = 0; iter < iterations; iter++ ) {
+        parallelFor( 0, numNodes, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t u = lo; u < hi; u++ )
+                contribution[u] = outDegree[u] > 0 ? rank[u] / outDegree[u] : 0;
+        } );
+
+        parallelForDynamic( 0, numNodes, 1024, [&]( int, size_t lo, size_t hi ) {
+            vector<int> neighbors( bufferSize );
+            for ( size_t v = lo; v < hi; v++ ) {
+                int degree = inGraph.decodeRow( v, neighbors.data() );
+                double sum = 0;
+                for ( int k = 0; k < degree; k++ )
+                    sum += contribution[neighbors[k]];
+                rank[v] = base + PAGERANK_DAMPING * sum;
+            } // for
+        } );
+    } // for
+
+    return rank;
+} // compressedPageRank
+
+// ---------------------------------------- 壓縮 CSR 檔
+// magic "REORDCMP"、format、numOfNodes、numOfEdges（各 8 bytes），接著 rowStart 與 data
+const char COMPRESSED_FILE_MAGIC[8] = { 'R', 'E', 'O', 'R', 'D', 'C', 'M', 'P' };
+
+inline void writeCompressedFile( const string & fileName, const CompressedGraph & graph ) {
+    ofstream outputFile( fileName, ios::binary );
+    if ( !outputFile ) {
+        cerr << "Error: Unable to open output file." << endl;
+        exit(1);
+    } // if
+
+    uint64_t fields[3] = { (uint64_t)graph.format, (uint64_t)graph.numOfNodes, (uint64_t)graph.numOfEdges };
+    outputFile.write( COMPRESSED_FILE_MAGIC, sizeof( COMPRESSED_FILE_MAGIC ) );
+    outputFile.write( reinterpret_cast<const char *>( fields ), sizeof( fields ) );
+    outputFile.write( reinterpret_cast<const char *>( graph.rowStart.data() ), graph.rowStart.size() * sizeof( uint64_t ) );
+    outputFile.write( reinterpret_cast<const char *>( graph.data.data() ), graph.rowStart.back() );
+    if ( !outputFile ) {
+        cerr << "Error: Unable to write output file." << endl;
+        exit(1);
+    } // if
+
+    outputFile.close();
+} // writeCompressedFile
+
+// 從 [ p, end ) 讀一個 varint，超出範圍或超過 5 bytes 時回傳 false
+inline bool readVarintBounded( const uint8_t * & p, const uint8_t * end, uint32_t & value ) {
+    value = 0;
+    for ( int shift = 0; shift < 35 && p < end; shift += 7 ) {
+        uint8_t byte = *p++;
+        value |= (uint32_t)( byte & 0x7F ) << shift;
+        if ( ( byte & 0x80 ) == 0 )
+            return true;
+    } // for
+
+    return false;
+} // readVarintBounded
+
+// 檢查第 node 列的編碼剛好填滿 [ rowStart[node], rowStart[node + 1] )，回傳 degree，不合法時回傳 -1
+inline int64_t validateCompressedRow( const CompressedGraph & graph, int node ) {
+    const uint8_t * p = graph.data.data() + graph.rowStart[node];
+    const uint8_t * end = graph.data.data() + graph.rowStart[node + 1];
+    uint32_t degree = 0, value = 0;
+    if ( !readVarintBounded( p, end, degree ) || degree > (uint32_t)INT_MAX )
+        return -1;
+    if ( degree == 0 )
+        return p == end ? 0 : -1;
+
+    if ( !readVarintBounded( p, end, value ) )
+        return -1;
+    int64_t neighbor = (int64_t)node + zigzagDecode( value );
+    if ( neighbor < 0 || neighbor >= graph.numOfNodes )
+        return -1;
+
+    if ( graph.format == VARINT_COMPRESSION ) {
+        for ( uint32_t i = 1; i < degree; i++ ) {
+            if ( !readVarintBounded( p, end, value ) )
+                return -1;
+            neighbor += value;
+            if ( neighbor >= graph.numOfNodes )
+                return -1;
+        } // for
+        return p == end ? (int64_t)degree : -1;
+    } // if
+
+    // bit-packing：長度由 degree 與位元寬度決定，解出後檢查最後（最大）的鄰居
+    if ( p == end || *p > 32 || (size_t)( end - p ) != 1 + 4 * packedWordsPerLane( degree - 1, *p ) * sizeof( uint32_t ) )
+        return -1;
+    vector<int> row( degree + 3 );
+    graph.decodeRow( node, row.data() );
+    for ( uint32_t i = 1; i < degree; i++ ) {
+        if ( row[i] < row[i - 1] || row[i] >= graph.numOfNodes )
+            return -1;
+    } // for
+    return degree;
+} // validateCompressedRow
+
+// 讀壓縮 CSR 檔：header、rowStart 與 data 的大小都先和檔案大小比對，
+// 再並行檢查每一列的編碼都在自己的範圍內、鄰居 ID 合法且 degree 總和等於邊數，解碼時才不會越界
+inline void loadCompressedFile( const string & fileName, CompressedGraph & graph ) {
+    ifstream input( fileName, ios::binary | ios::ate );
+    if ( !input ) {
+        cerr << "Error: Unable to open input file." << endl;
+        exit(1);
+    } // if
+
+    uint64_t fileSize = input.tellg();
+    input.seekg( 0 );
+    char magic[8];
+    uint64_t fields[3];
+    input.read( magic, sizeof( magic ) );
+    input.read( reinterpret_cast<char *>( fields ), sizeof( fields ) );
+    if ( !input || memcmp( magic, COMPRESSED_FILE_MAGIC, sizeof( magic ) ) != 0 ) {
+        cerr << "Error: not a compressed CSR file." << endl;
+        exit(1);
+    } // if
+
+    uint64_t headerBytes = sizeof( magic ) + sizeof( fields );
+    if ( fields[0] != VARINT_COMPRESSION && fields[0] != BITPACK_COMPRESSION ) {
+        cerr << "Error: unsupported compression format " << fields[0] << "." << endl;
+        exit(1);
+    } // if
+
+    if ( fields[1] > INT_MAX || fields[1] + 1 > ( fileSize - headerBytes ) / sizeof( uint64_t ) ) {
+        cerr << "Error: file illegal, compressed CSR node count is out of range." << endl;
+        exit(1);
+    } // if
+
+    graph.format = (CompressionFormat)fields[0];
+    graph.numOfNodes = fields[1];
+    graph.numOfEdges = fields[2];
+    graph.rowStart.resize( graph.numOfNodes + 1 );
+    input.read( reinterpret_cast<char *>( graph.rowStart.data() ), graph.rowStart.size() * sizeof( uint64_t ) );
+    uint64_t dataBytes = fileSize - headerBytes - graph.rowStart.size() * sizeof( uint64_t );
+    bool monotonic = input && graph.rowStart[0] == 0 && graph.rowStart.back() == dataBytes;
+    for ( int v = 0; monotonic && v < graph.numOfNodes; v++ )
+        monotonic = graph.rowStart[v] <= graph.rowStart[v + 1];
+    if ( !monotonic ) {
+        cerr << "Error: file illegal, compressed CSR row offsets are out of range." << endl;
+        exit(1);
+    } // if
+
+    graph.data.assign( dataBytes + COMPRESSED_PADDING, 0 );
+    input.read( reinterpret_cast<char *>( graph.data.data() ), dataBytes );
+    if ( !input ) {
+        cerr << "Error: compressed CSR file is truncated." << endl;
+        exit(1);
+    } // if
+
+    vector<uint64_t> threadEdges( numOfThreads(), 0 );
+    vector<char> threadIllegal( numOfThreads(), 0 );
+    parallelFor( 0, graph.numOfNodes, [&]( int tid, size_t lo, size_t hi ) {
+        for ( size_t v = lo; v < hi && !threadIllegal[tid]; v++ ) {
+            int64_t degree = validateCompressedRow( graph, v );
+            if ( degree < 0 )
+                threadIllegal[tid] = 1;
+            else
+                threadEdges[tid] += degree;
+        } // for
+    } );
+
+    uint64_t numEdges = 0;
+    for ( uint64_t edges : threadEdges )
+        numEdges += edges;
+    if ( count( threadIllegal.begin(), threadIllegal.end(), 1 ) > 0 || numEdges != graph.numOfEdges ) {
+        cerr << "Error: file illegal, compressed CSR rows are corrupt." << endl;
+        exit(1);
+    } // if
+} // loadCompressedFile
+
+#endif // COMPRESSED_GRAPH_H
@@ -0,0 +1,181 @@
+#ifndef GORDER_H
+#define GORDER_H
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "graph.h"
+#include "order.h"
+#include "parallel.h"
+
+using namespace std;
+
+// ---------------------------------------- Gorder（Wei et al., SIGMOD 2016）
+// 貪婪地一個一個放節點：下一個放的是與最近 window 個已放節點分數總和最大的節點，
+//     S( u, v ) = 共同入鄰居數 + u、v 之間的邊數
+// 新節點進入 window 時，與它有關的節點 key + 1；節點離開 window 時再 - 1，
+// key 只會加減 1，因此用 unit heap 做到 O(1) 更新。
+// 共同入鄰居透過「入鄰居 u 的所有出鄰居」找出；out-degree 超過 hubThreshold 的 u
+// 幾乎和每個節點都是兄弟，更新量大又沒有鑑別度，直接略過。
+
+// key 只會加減 1 的 max heap：每個 key 一條雙向串列，更新、取最大值都是 O(1)（均攤）
+class UnitHeap {
+public:
+    // 所有節點的 key 為 0，串列依 initialOrder 排列（同 key 時先出來）
+    explicit UnitHeap( const vector<int> & initialOrder )
+        : key( initialOrder.size(), 0 ), prev( initialOrder.size(), -1 ), next( initialOrder.size(), -1 ),
+          removed( initialOrder.size(), 0 ), head( 1, -1 ), top( 0 ) {
+        for ( int i = (int)initialOrder.size() - 1; i >= 0; i-- )
+            pushFront( initialOrder[i] );
+    } // UnitHeap
+
+    void increment( int node ) {
+        if ( removed[node] )
+            return;
+
+        unlink( node );
+        key[node]++;
+        if ( key[node] == (int)head.size() )
+            head.push_back( -1 );
+        pushFront( node );
+        top = max( top, key[node] );
+    } // increment
+
+    void decrement( int node ) {
+        if ( removed[node] || key[node] == 0 )
+            return;
+
+        unlink( node );
+        key[node]--;
+        pushFront( node );
+    } // decrement
+
+    // 取出並移除 key 最大的節點，heap 已空時回傳 -1
+    int popMax() {
+        while ( top > 0 && head[top] == -1 )
+            top--;
+
+        int node = head[top];
+        if ( node != -1 )
+            remove( node );
+        return node;
+    } // popMax
+
+    void remove( int node ) {
+        if ( removed[node] )
+            return;
+
+        unlink( node );
+        removed[node] = 1;
+    } // remove
+
+private:
+    vector<int> key;
+    vector<int> prev;
+    vector<int> next;
+    vector<char> removed;
+    vector<int> head;       // head[k]：key 為 k 的串列開頭，-1 表示空
+    int top;                // 不小於目前最大 key
+
+    void pushFront( int node ) {
+        int first = head[key[node]];
+        prev[node] = -1;
+        next[node] = first;
+        if ( first != -1 )
+            prev[first] = node;
+        head[key[node]] = node;
+    } // pushFront
+
+    void unlink( int node ) {
+        if ( prev[node] != -1 )
+            next[prev[node]] = next[node];
+        else
+            head[key[node]] = next[node];
+        if ( next[node] != -1 )
+            prev[next[node]] = prev[node];
+    } // unlink
+};
+
+class GOrder : public Ordering {
+public:
+    // hubThreshold 為 0 時使用 sqrt( 節點數 )
+    explicit GOrder( int window = 5, int hubThreshold = 0 ) : window( window ), hubThreshold( hubThreshold ) {}
+
+    string name() const override { return "Gorder"; }
+
+    Permutation compute( const CsrGraph & graph ) const override {
+        int numOfNodes = graph.numOfNodes;
+        if ( numOfNodes == 0 )
+            return Permutation();
+
+        CsrGraph inGraph;
+        transposeCSR( graph, inGraph );
+
+        int hub = hubThreshold > 0 ? hubThreshold : max( 1, (int)sqrt( (double)numOfNodes ) );
+        int w = max( 1, window );
+
+        // 同分時 in-degree 大的先放（同 in-degree 依 ID）
+        vector<int> degree = countDegree( graph, IN_DEGREE );
+        int maximum = maxDegree( degree );
+        parallelFor( 0, numOfNodes, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t v = lo; v < hi; v++ )
+                degree[v] = maximum - degree[v];
+        } );
+        vector<int> initialOrder = sortByKey( degree, maximum + 1 );
+
+        UnitHeap heap( initialOrder );
+        vector<int> order;
+        order.reserve( numOfNodes );
+
+        for ( int i = 0; i < numOfNodes; i++ ) {
+            int node = heap.popMax();
+            order.push_back( node );
+
+            // node 進入 window
+            update( graph, inGraph, heap, node, hub, true );
+
+            // 最舊的節點離開 window
+            if ( i >= w )
+                update( graph, inGraph, heap, order[i - w], hub, false );
+        } // for
+
+        return permutationFromOrder( order, numOfNodes );
+    } // compute
+
+private:
+    int window;
+    int hubThreshold;
+
+    // node 進入（add 為 true）或離開 window 時，調整與它分數相關節點的 key
+    static void update( const CsrGraph & graph, const CsrGraph & inGraph, UnitHeap & heap, int node, int hub,
+                        bool add ) {
+        auto change = [&]( int v ) {
+            if ( add )
+                heap.increment( v );
+            else
+                heap.decrement( v );
+        };
+
+        // node -> v
+        for ( int e = graph.offsets[node]; e < graph.offsets[node + 1]; e++ )
+            change( graph.edges[e] );
+
+        for ( int e = inGraph.offsets[node]; e < inGraph.offsets[node + 1]; e++ ) {
+            // u -> node
+            int u = inGraph.edges[e];
+            change( u );
+
+            // u 的其他出鄰居與 node 有共同入鄰居 u
+            if ( graph.degree( u ) > hub )
+                continue;
+            for ( int f = graph.offsets[u]; f < graph.offsets[u + 1]; f++ ) {
+                if ( graph.edges[f] != node )
+                    change( graph.edges[f] );
+            } // for
+        } // for
+    } // update
+};
+
+#endif // GORDER_H
@@ -0,0 +1,539 @@
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstdint>
+#include <climits>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "parallel.h"
+
+using namespace std;
+
+// 邊與 CSR 依節點 ID 的型別（NodeID）與 offset 的型別（EdgeID）做成 template。
+// 提供兩種組合：CsrGraph 全部 32 位元，省記憶體；邊數超過 INT_MAX 時用 CsrGraph64（64 位元 offsets），
+// 由 needsWideOffsets 依輸入大小在執行時選擇。節點 ID 都是 32 位元（Permutation 也是 int）
+template <class NodeID>
+struct BasicEdge {
+    NodeID src;
+    NodeID dst;
+};
+
+typedef BasicEdge<int> Edge;
+
+// edge list 與節點數量（最大 ID + 1）
+struct EdgeList {
+    vector<Edge> edges;
+    int numOfNodes = 0;
+};
+
+// CSR 圖
+// offsets / edges 指向自己持有的 vector，或指向 mmap 進來的檔案內容，
+// BFS/DFS 等演算法只透過指標存取，因此兩種來源都不需要複製
+template <class NodeID, class EdgeID>
+struct BasicCsrGraph {
+    typedef NodeID NodeType;
+    typedef EdgeID EdgeType;
+
+    NodeID numOfNodes = 0;
+    EdgeID numOfEdges = 0;
+    const EdgeID * offsets = nullptr;       // 長度 numOfNodes + 1
+    const NodeID * edges = nullptr;         // 長度 numOfEdges
+    const NodeID * permutation = nullptr;   // 選用，舊 ID -> 新 ID，長度 numOfNodes
+
+    vector<EdgeID> csrOffsetArray;
+    vector<NodeID> csrEdgeArray;
+    vector<NodeID> permutationArray;
+    shared_ptr<const void> storage;         // mmap 時保持檔案映射
+
+    BasicCsrGraph() = default;
+    BasicCsrGraph( const BasicCsrGraph & ) = delete;
+    BasicCsrGraph & operator=( const BasicCsrGraph & ) = delete;
+    BasicCsrGraph( BasicCsrGraph && ) = default;
+    BasicCsrGraph & operator=( BasicCsrGraph && ) = default;
+
+    // 接手 vector 的內容（不複製），原本的 vector 會被清空
+    void adopt( vector<EdgeID> & offsetArray, vector<NodeID> & edgeArray ) {
+        csrOffsetArray.swap( offsetArray );
+        csrEdgeArray.swap( edgeArray );
+        offsetArray.clear();
+        edgeArray.clear();
+        if ( csrOffsetArray.empty() )
+            csrOffsetArray.push_back( 0 );
+        numOfNodes = csrOffsetArray.size() - 1;
+        numOfEdges = csrEdgeArray.size();
+        offsets = csrOffsetArray.data();
+        edges = csrEdgeArray.data();
+        permutation = nullptr;
+    } // adopt
+
+    EdgeID degree( NodeID node ) const {
+        return offsets[node + 1] - offsets[node];
+    } // degree
+};
+
+typedef BasicCsrGraph<int, int> CsrGraph;
+typedef BasicCsrGraph<int, int64_t> CsrGraph64;
+
+// 邊數超過 int 範圍時 offsets 需要 64 位元
+inline bool needsWideOffsets( uint64_t numOfEdges ) {
+    return numOfEdges > (uint64_t)INT_MAX;
+} // needsWideOffsets
+
+// 節點重新編號：newID[ 舊 ID ] = 新 ID
+struct Permutation {
+    vector<int> newID;
+
+    int size() const {
+        return newID.size();
+    } // size
+};
+
+// 將圖的 edge list 格式轉換為 CSR 格式（並行）
+// 1. 來源節點切成連續的區段，各執行緒統計自己那段邊落在各區段的數量
+// 2. 依 ( 區段, 執行緒 ) 的順序做前綴和，把邊穩定地分到暫存陣列
+// 3. 每個區段由一個執行緒算 degree、前綴和，再填入 csrEdgeArray
+// 每一列的鄰居維持 edge list 中的順序，結果與執行緒數量無關；
+// sortNeighbors 為 true 時再把每一列的鄰居由小到大排序；
+// transpose 為 true 時以反向邊 ( dst -> src ) 建構，得到入邊的 CSR
+template <class NodeID, class EdgeID>
+void convertToCSR( const vector<BasicEdge<NodeID>> & edgeList, vector<EdgeID> & csrOffsetArray, vector<NodeID> & csrEdgeArray,
+                   bool sortNeighbors = false, bool transpose = false ) {
+    typedef BasicEdge<NodeID> EdgeType;
+    size_t numEdges = edgeList.size();
+    const EdgeType * edge = edgeList.data();
+    int numThreads = numOfThreads();
+    auto rowOf = [transpose]( const EdgeType & e ) { return transpose ? e.dst : e.src; };
+    auto colOf = [transpose]( const EdgeType & e ) { return transpose ? e.src : e.dst; };
+
+    // 確定節點數量
+    vector<NodeID> threadMax( numThreads, -1 );
+    parallelFor( 0, numEdges, [&]( int tid, size_t lo, size_t hi ) {
+        NodeID localMax = -1;
+        for ( size_t i = lo; i < hi; i++ )
+            localMax = max( localMax, max( edge[i].src, edge[i].dst ) );
+        threadMax[tid] = localMax;
+    } );
+
+    NodeID numNodes = *max_element( threadMax.begin(), threadMax.end() ) + 1;
+    csrOffsetArray.assign( numNodes + 1, 0 );
+    csrEdgeArray.resize( numEdges );
+    if ( numNodes == 0 )
+        return;
+
+    // 單執行緒時整個圖就是一個區段，不需要分桶
+    size_t numBlocks = numThreads == 1 ? 1 : min<size_t>( numNodes, numThreads * 16 );
+    size_t blockSize = ( numNodes + numBlocks - 1 ) / numBlocks;
+    numBlocks = ( numNodes + blockSize - 1 ) / blockSize;
+    vector<size_t> blockStart( numBlocks + 1, 0 );
+    blockStart[numBlocks] = numEdges;
+
+    vector<EdgeType> bucketed;
+    const EdgeType * source = edge;
+    if ( numBlocks > 1 ) {
+        // 各執行緒統計每個區段的邊數，bucketCount[ tid * numBlocks + block ]
+        vector<size_t> bucketCount( numThreads * numBlocks, 0 );
+        parallelFor( 0, numEdges, [&]( int tid, size_t lo, size_t hi ) {
+            size_t * count = bucketCount.data() + tid * numBlocks;
+            for ( size_t i = lo; i < hi; i++ )
+                count[rowOf( edge[i] ) / blockSize]++;
+        } );
+
+        // 前綴和後 bucketCount 變成每個桶在暫存陣列的起點
+        size_t sum = 0;
+        for ( size_t b = 0; b < numBlocks; b++ ) {
+            blockStart[b] = sum;
+            for ( int t = 0; t < numThreads; t++ ) {
+                size_t count = bucketCount[t * numBlocks + b];
+                bucketCount[t * numBlocks + b] = sum;
+                sum += count;
+            } // for
+        } // for
+
+        bucketed.resize( numEdges );
+        parallelFor( 0, numEdges, [&]( int tid, size_t lo, size_t hi ) {
+            size_t * cursor = bucketCount.data() + tid * numBlocks;
+            for ( size_t i = lo; i < hi; i++ )
+                bucketed[cursor[rowOf( edge[i] ) / blockSize]++] = edge[i];
+        } );
+
+        source = bucketed.data();
+    } // if
+
+    // 每個區段只寫 csrOffsetArray[v + 1]（v 屬於該區段），彼此不衝突
+    EdgeID * offset = csrOffsetArray.data();
+    NodeID * target = csrEdgeArray.data();
+    parallelForDynamic( 0, numBlocks, 1, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t b = lo; b < hi; b++ ) {
+            NodeID first = b * blockSize;
+            NodeID last = min<size_t>( numNodes, first + blockSize );
+
+            // 計算每個節點的鄰居數量
+            for ( size_t i = blockStart[b]; i < blockStart[b + 1]; i++ )
+                offset[rowOf( source[i] ) + 1]++;
+
+            // 累積計算每個節點的起始位置，先暫存在 offset[v + 1]
+            EdgeID running = blockStart[b];
+            for ( NodeID v = first; v < last; v++ ) {
+                EdgeID count = offset[v + 1];
+                offset[v + 1] = running;
+                running += count;
+            } // for
+
+            // 依序填入鄰居，填完後 offset[v + 1] 正好是 v 的結束位置
+            for ( size_t i = blockStart[b]; i < blockStart[b + 1]; i++ )
+                target[offset[rowOf( source[i] ) + 1]++] = colOf( source[i] );
+
+            if ( sortNeighbors ) {
+                EdgeID rowStart = blockStart[b];
+                for ( NodeID v = first; v < last; v++ ) {
+                    sort( target + rowStart, target + offset[v + 1] );
+                    rowStart = offset[v + 1];
+                } // for
+            } // if
+        } // for
+    } );
+} // convertToCSR
+
+// 把 edge list 建成 CsrGraph（或 CsrGraph64）
+template <class EdgeID>
+void convertToCSR( const EdgeList & edgeList, BasicCsrGraph<int, EdgeID> & graph, bool sortNeighbors = false, bool transpose = false ) {
+    vector<EdgeID> csrOffsetArray;
+    vector<int> csrEdgeArray;
+    convertToCSR( edgeList.edges, csrOffsetArray, csrEdgeArray, sortNeighbors, transpose );
+    graph.adopt( csrOffsetArray, csrEdgeArray );
+} // convertToCSR
+
+// 由 CSR 建立反向（入邊）的 CSR，即 CSC：inGraph 第 v 列是所有指向 v 的節點，由小到大排序
+// 與 convertToCSR 相同的分桶方式，直接讀 CSR，不經過 edge list、也不需要 atomic：
+// 1. 目的節點切成連續的區段，各執行緒依邊的順序統計自己那段邊落在各區段的數量
+// 2. 依 ( 區段, 執行緒 ) 的順序前綴和，把 ( src, dst ) 穩定地分到暫存陣列
+// 3. 每個區段由一個執行緒計算 in-degree、前綴和，再填入來源節點
+// 邊依來源節點由小到大掃過，分桶又是穩定的，所以每列不必再排序，結果與執行緒數量無關
+template <class NodeID, class EdgeID>
+void transposeCSR( const BasicCsrGraph<NodeID, EdgeID> & graph, BasicCsrGraph<NodeID, EdgeID> & inGraph ) {
+    typedef BasicEdge<NodeID> EdgeType;
+    NodeID numNodes = graph.numOfNodes;
+    size_t numEdges = graph.numOfEdges;
+    int numThreads = numOfThreads();
+    vector<EdgeID> csrOffsetArray( numNodes + 1, 0 );
+    vector<NodeID> csrEdgeArray( numEdges );
+    EdgeID * offset = csrOffsetArray.data();
+    NodeID * target = csrEdgeArray.data();
+
+    // 單執行緒時整個圖就是一個區段，直接依 CSR 的順序計數、填入
+    if ( numThreads == 1 || numNodes < 2 ) {
+        for ( size_t e = 0; e < numEdges; e++ )
+            offset[graph.edges[e] + 1]++;
+
+        EdgeID running = 0;
+        for ( NodeID v = 0; v < numNodes; v++ ) {
+            EdgeID count = offset[v + 1];
+            offset[v + 1] = running;
+            running += count;
+        } // for
+
+        for ( NodeID u = 0; u < numNodes; u++ ) {
+            for ( EdgeID e = graph.offsets[u]; e < graph.offsets[u + 1]; e++ )
+                target[offset[graph.edges[e] + 1]++] = u;
+        } // for
+
+        inGraph.adopt( csrOffsetArray, csrEdgeArray );
+        return;
+    } // if
+
+    size_t numBlocks = min<size_t>( numNodes, numThreads * 16 );
+    size_t blockSize = ( numNodes + numBlocks - 1 ) / numBlocks;
+    numBlocks = ( numNodes + blockSize - 1 ) / blockSize;
+
+    // 各執行緒處理連續的一段邊，第一條邊的來源節點以二分搜尋找到
+    auto forEachEdge = [&]( size_t lo, size_t hi, auto func ) {
+        NodeID u = upper_bound( graph.offsets, graph.offsets + numNodes + 1, (EdgeID)lo ) - graph.offsets - 1;
+        for ( size_t e = lo; e < hi; e++ ) {
+            while ( (size_t)graph.offsets[u + 1] <= e )
+                u++;
+            func( u, graph.edges[e] );
+        } // for
+    };
+
+    // bucketCount[ tid * numBlocks + block ]，前綴和後變成每個桶在暫存陣列的起點
+    vector<size_t> bucketCount( numThreads * numBlocks, 0 );
+    parallelFor( 0, numEdges, [&]( int tid, size_t lo, size_t hi ) {
+        size_t * count = bucketCount.data() + tid * numBlocks;
+        forEachEdge( lo, hi, [&]( NodeID, NodeID v ) { count[v / blockSize]++; } );
+    } );
+
+    vector<size_t> blockStart( numBlocks + 1, numEdges );
+    size_t sum = 0;
+    for ( size_t b = 0; b < numBlocks; b++ ) {
+        blockStart[b] = sum;
+        for ( int t = 0; t < numThreads; t++ ) {
+            size_t count = bucketCount[t * numBlocks + b];
+            bucketCount[t * numBlocks + b] = sum;
+            sum += count;
+        } // for
+    } // for
+
+    vector<EdgeType> bucketed( numEdges );
+    parallelFor( 0, numEdges, [&]( int tid, size_t lo, size_t hi ) {
+        size_t * cursor = bucketCount.data() + tid * numBlocks;
+        forEachEdge( lo, hi, [&]( NodeID u, NodeID v ) { bucketed[cursor[v / blockSize]++] = { u, v }; } );
+    } );
+
+    // 每個區段只寫 offset[v + 1]（v 屬於該區段），彼此不衝突
+    parallelForDynamic( 0, numBlocks, 1, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t b = lo; b < hi; b++ ) {
+            NodeID first = b * blockSize;
+            NodeID last = min<size_t>( numNodes, first + blockSize );
+            for ( size_t i = blockStart[b]; i < blockStart[b + 1]; i++ )
+                offset[bucketed[i].dst + 1]++;
+
+            EdgeID running = blockStart[b];
+            for ( NodeID v = first; v < last; v++ ) {
+                EdgeID count = offset[v + 1];
+                offset[v + 1] = running;
+                running += count;
+            } // for
+
+            for ( size_t i = blockStart[b]; i < blockStart[b + 1]; i++ )
+                target[offset[bucketed[i].dst + 1]++] = bucketed[i].src;
+        } // for
+    } );
+
+    inGraph.adopt( csrOffsetArray, csrEdgeArray );
+} // transposeCSR
+
+// 無向化：第 v 列是 v 的出鄰居（graph）與入鄰居（inGraph，graph 的反向）的聯集，由小到大、不重複、不含自己
+template <class NodeID, class EdgeID>
+void symmetrizeCSR( const BasicCsrGraph<NodeID, EdgeID> & graph, const BasicCsrGraph<NodeID, EdgeID> & inGraph,
+                    BasicCsrGraph<NodeID, EdgeID> & undirected ) {
+    NodeID numNodes = graph.numOfNodes;
+
+    // 合併一列的出、入鄰居到 row（已排序、去重）；入鄰居本來就由小到大
+    auto mergeRow = [&]( NodeID v, vector<NodeID> & row ) {
+        row.assign( graph.edges + graph.offsets[v], graph.edges + graph.offsets[v + 1] );
+        sort( row.begin(), row.end() );
+        size_t outSize = row.size();
+        row.insert( row.end(), inGraph.edges + inGraph.offsets[v], inGraph.edges + inGraph.offsets[v + 1] );
+        inplace_merge( row.begin(), row.begin() + outSize, row.end() );
+        row.erase( unique( row.begin(), row.end() ), row.end() );
+        row.erase( remove( row.begin(), row.end(), v ), row.end() );
+    };
+
+    // 第一輪算每列大小，第二輪填入
+    vector<EdgeID> csrOffsetArray( numNodes + 1, 0 );
+    parallelForDynamic( 0, numNodes, 1024, [&]( int, size_t lo, size_t hi ) {
+        vector<NodeID> row;
+        for ( size_t v = lo; v < hi; v++ ) {
+            mergeRow( v, row );
+            csrOffsetArray[v + 1] = row.size();
+        } // for
+    } );
+
+    for ( NodeID v = 1; v <= numNodes; v++ )
+        csrOffsetArray[v] += csrOffsetArray[v - 1];
+
+    vector<NodeID> csrEdgeArray( csrOffsetArray[numNodes] );
+    parallelForDynamic( 0, numNodes, 1024, [&]( int, size_t lo, size_t hi ) {
+        vector<NodeID> row;
+        for ( size_t v = lo; v < hi; v++ ) {
+            mergeRow( v, row );
+            copy( row.begin(), row.end(), csrEdgeArray.begin() + csrOffsetArray[v] );
+        } // for
+    } );
+
+    undirected.adopt( csrOffsetArray, csrEdgeArray );
+} // symmetrizeCSR
+
+template <class NodeID, class EdgeID>
+void symmetrizeCSR( const BasicCsrGraph<NodeID, EdgeID> & graph, BasicCsrGraph<NodeID, EdgeID> & undirected ) {
+    BasicCsrGraph<NodeID, EdgeID> inGraph;
+    transposeCSR( graph, inGraph );
+    symmetrizeCSR( graph, inGraph, undirected );
+} // symmetrizeCSR
+
+// 同時保存出邊（push 方向）與入邊（pull 方向：pull PageRank、bottom-up BFS）的圖。
+// symmetric 為 true 時 out 是無向化後的圖，兩個方向相同，in 不另外存
+template <class NodeID, class EdgeID>
+struct BasicBidirectionalGraph {
+    BasicCsrGraph<NodeID, EdgeID> out;
+    BasicCsrGraph<NodeID, EdgeID> in;
+    bool symmetric = false;
+
+    const BasicCsrGraph<NodeID, EdgeID> & outEdges() const {
+        return out;
+    } // outEdges
+
+    const BasicCsrGraph<NodeID, EdgeID> & inEdges() const {
+        return symmetric ? out : in;
+    } // inEdges
+};
+
+typedef BasicBidirectionalGraph<int, int> BidirectionalGraph;
+typedef BasicBidirectionalGraph<int, int64_t> BidirectionalGraph64;
+
+// 接手 graph 作為出邊並建立入邊；symmetrize 為 true 時改存無向化後的圖
+template <class NodeID, class EdgeID>
+void buildBidirectionalGraph( BasicCsrGraph<NodeID, EdgeID> && graph, BasicBidirectionalGraph<NodeID, EdgeID> & result,
+                              bool symmetrize = false ) {
+    result.symmetric = symmetrize;
+    result.in = BasicCsrGraph<NodeID, EdgeID>();
+    if ( symmetrize ) {
+        BasicCsrGraph<NodeID, EdgeID> undirected;
+        symmetrizeCSR( graph, undirected );
+        result.out = move( undirected );
+    } // if
+    else {
+        result.out = move( graph );
+        transposeCSR( result.out, result.in );
+    } // else
+} // buildBidirectionalGraph
+
+// 依新順序排列的舊 ID（order[ 新 ID ] = 舊 ID）轉成 Permutation，
+// order 中沒出現的節點依 ID 由小到大接在後面
+inline Permutation permutationFromOrder( const vector<int> & order, int numOfNodes ) {
+    Permutation permutation;
+    permutation.newID.assign( numOfNodes, -1 );
+    parallelFor( 0, order.size(), [&]( int, size_t lo, size_t hi ) {
+        for ( size_t i = lo; i < hi; i++ )
+            permutation.newID[order[i]] = i;
+    } );
+
+    int next = order.size();
+    for ( int v = 0; v < numOfNodes; v++ ) {
+        if ( permutation.newID[v] == -1 )
+            permutation.newID[v] = next++;
+    } // for
+
+    return permutation;
+} // permutationFromOrder
+
+// 反查：order[ 新 ID ] = 舊 ID
+inline vector<int> inversePermutation( const Permutation & permutation ) {
+    vector<int> order( permutation.size() );
+    parallelFor( 0, permutation.size(), [&]( int, size_t lo, size_t hi ) {
+        for ( size_t v = lo; v < hi; v++ )
+            order[permutation.newID[v]] = v;
+    } );
+
+    return order;
+} // inversePermutation
+
+// 先套用 first 再套用 second 的結果：newID[ v ] = second.newID[ first.newID[ v ] ]
+inline Permutation composePermutation( const Permutation & first, const Permutation & second ) {
+    if ( first.size() != second.size() ) {
+        cerr << "Error: permutations have different sizes." << endl;
+        exit(1);
+    } // if
+
+    Permutation result;
+    result.newID.resize( first.size() );
+    parallelFor( 0, first.size(), [&]( int, size_t lo, size_t hi ) {
+        for ( size_t v = lo; v < hi; v++ )
+            result.newID[v] = second.newID[first.newID[v]];
+    } );
+
+    return result;
+} // composePermutation
+
+// 依 permutation 改寫 edge list 兩端的 ID
+inline void applyPermutation( EdgeList & edgeList, const Permutation & permutation ) {
+    Edge * edge = edgeList.edges.data();
+    const int * newID = permutation.newID.data();
+    parallelFor( 0, edgeList.edges.size(), [&]( int, size_t lo, size_t hi ) {
+        for ( size_t i = lo; i < hi; i++ ) {
+            edge[i].src = newID[edge[i].src];
+            edge[i].dst = newID[edge[i].dst];
+        } // for
+    } );
+} // applyPermutation
+
+// 依 permutation 直接產生重新編號後的 CSR（並行）：
+// 新 offsets 由換位後的 degree 前綴和得到，每列搬到新位置、鄰居換成新 ID 後排序。
+// result.permutation 記錄使用的 permutation（舊 ID -> 新 ID）
+template <class EdgeID>
+void applyPermutation( const BasicCsrGraph<int, EdgeID> & graph, const Permutation & permutation, BasicCsrGraph<int, EdgeID> & result ) {
+    int numNodes = graph.numOfNodes;
+    const int * newID = permutation.newID.data();
+
+    vector<EdgeID> csrOffsetArray( numNodes + 1, 0 );
+    parallelFor( 0, numNodes, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t u = lo; u < hi; u++ )
+            csrOffsetArray[newID[u] + 1] = graph.degree( u );
+    } );
+
+    for ( int v = 1; v <= numNodes; v++ )
+        csrOffsetArray[v] += csrOffsetArray[v - 1];
+
+    vector<int> csrEdgeArray( graph.numOfEdges );
+    parallelForDynamic( 0, numNodes, 1024, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t u = lo; u < hi; u++ ) {
+            int * row = csrEdgeArray.data() + csrOffsetArray[newID[u]];
+            EdgeID degree = graph.degree( u );
+            const int * neighbor = graph.edges + graph.offsets[u];
+            for ( EdgeID i = 0; i < degree; i++ )
+                row[i] = newID[neighbor[i]];
+            sort( row, row + degree );
+        } // for
+    } );
+
+    result.adopt( csrOffsetArray, csrEdgeArray );
+    result.permutationArray = permutation.newID;
+    result.permutation = result.permutationArray.data();
+} // applyPermutation
+
+// 兩個方向以同一個 permutation 重新編號，新圖的 in 仍是 out 的反向
+template <class EdgeID>
+void applyPermutation( const BasicBidirectionalGraph<int, EdgeID> & graph, const Permutation & permutation,
+                       BasicBidirectionalGraph<int, EdgeID> & result ) {
+    result.symmetric = graph.symmetric;
+    applyPermutation( graph.out, permutation, result.out );
+    if ( graph.symmetric )
+        result.in = BasicCsrGraph<int, EdgeID>();
+    else
+        applyPermutation( graph.in, permutation, result.in );
+} // applyPermutation
+
+// ---------------------------------------- 原地排序 edge list
+// 每條邊視為 64 位元的 key（src 在高位，兩端各用最大 ID 需要的位數），
+// 以 parallelFlagSort（原地的 American flag sort）排序，記憶體只有 edge list 本身
+
+inline uint64_t edgeSortKey( const Edge & edge, int idBits ) {
+    return ( (uint64_t)edge.src << idBits ) | (uint32_t)edge.dst;
+} // edgeSortKey
+
+// 依 ( src, dst ) 原地排序 edge list；removeDuplicates 為 true 時排序後去掉重複的邊。回傳去掉的邊數
+inline size_t sortEdgeList( EdgeList & edgeList, bool removeDuplicates = false ) {
+    vector<Edge> & edges = edgeList.edges;
+    size_t numEdges = edges.size();
+    int numThreads = numOfThreads();
+    vector<int> threadMax( numThreads, 0 );
+    parallelFor( 0, numEdges, [&]( int tid, size_t lo, size_t hi ) {
+        int localMax = 0;
+        for ( size_t i = lo; i < hi; i++ )
+            localMax = max( localMax, max( edges[i].src, edges[i].dst ) );
+        threadMax[tid] = localMax;
+    } );
+
+    int idBits = 1;
+    for ( int maximum = *max_element( threadMax.begin(), threadMax.end() ); maximum >> idBits; )
+        idBits++;
+
+    parallelFlagSort( edges.data(), numEdges, 2 * idBits, [idBits]( const Edge & edge ) {
+        return edgeSortKey( edge, idBits );
+    } );
+
+    if ( removeDuplicates ) {
+        auto last = unique( edges.begin(), edges.end(), []( const Edge & a, const Edge & b ) {
+            return a.src == b.src && a.dst == b.dst;
+        } );
+        edges.erase( last, edges.end() );
+    } // if
+
+    return numEdges - edges.size();
+} // sortEdgeList
+
+#endif // GRAPH_H
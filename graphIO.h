@@ -0,0 +1,817 @@
+#ifndef GRAPH_IO_H
+#define GRAPH_IO_H
+
+#include <iostream>
+#include <cstdlib>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <climits>
+#include <limits>
+#include <algorithm>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "graph.h"
+#include "parallel.h"
+
+using namespace std;
+
+// 以 mmap 唯讀映射整個檔案，物件解構時解除映射
+class MappedFile {
+public:
+    explicit MappedFile( const string & fileName ) {
+        int fd = open( fileName.c_str(), O_RDONLY );
+        if ( fd < 0 ) {
+            cerr << "Error: Unable to open input file." << endl;
+            exit(1);
+        } // if
+
+        struct stat fileStat;
+        if ( fstat( fd, &fileStat ) != 0 ) {
+            cerr << "Error: Unable to stat input file." << endl;
+            exit(1);
+        } // if
+
+        length = fileStat.st_size;
+        if ( length > 0 ) {
+            void * addr = mmap( nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0 );
+            if ( addr == MAP_FAILED ) {
+                cerr << "Error: Unable to map input file." << endl;
+                exit(1);
+            } // if
+
+            bytes = static_cast<const char *>( addr );
+        } // if
+
+        close( fd );
+    } // MappedFile
+
+    ~MappedFile() {
+        if ( bytes != nullptr )
+            munmap( const_cast<char *>( bytes ), length );
+    } // ~MappedFile
+
+    MappedFile( const MappedFile & ) = delete;
+    MappedFile & operator=( const MappedFile & ) = delete;
+
+    const char * data() const { return bytes; }
+    size_t size() const { return length; }
+
+    void advise( int advice ) const {
+        if ( bytes != nullptr )
+            madvise( const_cast<char *>( bytes ), length, advice );
+    } // advise
+
+private:
+    const char * bytes = nullptr;
+    size_t length = 0;
+};
+
+// 跳過空白後讀一個非負整數，成功時 p 停在數字之後；
+// 數字太長超出 unsigned long long 時固定為 ULLONG_MAX，交給呼叫者的範圍檢查回報
+inline bool scanUnsigned( const char * & p, const char * end, unsigned long long & value ) {
+    while ( p < end && ( *p == ' ' || *p == '\t' ) )
+        p++;
+
+    if ( p == end || *p < '0' || *p > '9' )
+        return false;
+
+    unsigned long long v = 0;
+    while ( p < end && *p >= '0' && *p <= '9' ) {
+        unsigned digit = *p - '0';
+        if ( v > ( ULLONG_MAX - digit ) / 10 )
+            v = ULLONG_MAX;
+        else
+            v = v * 10 + digit;
+        p++;
+    } // while
+
+    value = v;
+    return true;
+} // scanUnsigned
+
+// 這一行是否要當成邊解析：只有空行（含 \r）與 % 或 # 開頭的註解會跳過，
+// 其他行（例如負數或文字）都算，解析失敗時由呼叫者回報檔案不合法
+inline bool isEdgeLine( const char * p, const char * end ) {
+    while ( p < end && ( *p == ' ' || *p == '\t' || *p == '\r' ) )
+        p++;
+
+    return p < end && *p != '\n' && *p != '%' && *p != '#';
+} // isEdgeLine
+
+// 回傳下一行的開頭
+inline const char * nextLine( const char * p, const char * end ) {
+    const char * newline = static_cast<const char *>( memchr( p, '\n', end - p ) );
+    return newline == nullptr ? end : newline + 1;
+} // nextLine
+
+// 以 mmap 讀入 edge list：
+// 檔案切成以換行對齊的區塊，第一輪並行計算每塊的邊數，
+// 依前綴和一次配置好 edgeList，第二輪並行解析並直接寫入各自的位置。
+// 每行取前兩個整數，其餘欄位（權重、時間戳）忽略。
+// minID / maxID 為所有端點的最小與最大 ID，沒有邊時為 0 / -1
+inline void loadEdgeList( const string & fileName, vector<Edge> & edgeList, int & minID, int & maxID ) {
+    MappedFile file( fileName );
+    file.advise( MADV_SEQUENTIAL );
+    const char * begin = file.data();
+    const char * end = begin + file.size();
+
+    // 切出以換行對齊的區塊
+    int numChunks = numOfThreads();
+    vector<const char *> bound( numChunks + 1, end );
+    bound.at(0) = begin;
+    for ( int i = 1; i < numChunks; i++ ) {
+        const char * p = begin + file.size() * i / numChunks;
+        if ( p < bound.at(i - 1) )
+            p = bound.at(i - 1);
+        else if ( p > begin && *( p - 1 ) != '\n' )
+            p = nextLine( p, end );
+        bound.at(i) = p;
+    } // for
+
+    // 第一輪：計算每個區塊的邊數
+    vector<size_t> chunkOffset( numChunks + 1, 0 );
+    parallelFor( 0, numChunks, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t c = lo; c < hi; c++ ) {
+            size_t count = 0;
+            for ( const char * p = bound[c]; p < bound[c + 1]; p = nextLine( p, bound[c + 1] ) ) {
+                if ( isEdgeLine( p, bound[c + 1] ) )
+                    count++;
+            } // for
+
+            chunkOffset[c + 1] = count;
+        } // for
+    } );
+
+    for ( int i = 1; i <= numChunks; i++ )
+        chunkOffset.at(i) += chunkOffset.at(i - 1);
+
+    edgeList.resize( chunkOffset.at(numChunks) );
+
+    // 第二輪：解析並寫入預先配置好的位置
+    vector<unsigned long long> chunkMin( numChunks, ULLONG_MAX ), chunkMax( numChunks, 0 );
+    vector<char> chunkIllegal( numChunks, 0 );
+    parallelFor( 0, numChunks, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t c = lo; c < hi; c++ ) {
+            Edge * out = edgeList.data() + chunkOffset[c];
+            unsigned long long localMin = ULLONG_MAX, localMax = 0;
+            const char * chunkEnd = bound[c + 1];
+            for ( const char * p = bound[c]; p < chunkEnd; p = nextLine( p, chunkEnd ) ) {
+                if ( !isEdgeLine( p, chunkEnd ) )
+                    continue;
+
+                unsigned long long node1 = 0, node2 = 0;
+                const char * q = p;
+                if ( !scanUnsigned( q, chunkEnd, node1 ) || !scanUnsigned( q, chunkEnd, node2 ) ) {
+                    chunkIllegal[c] = 1;
+                    break;
+                } // if
+
+                out->src = static_cast<int>( node1 );
+                out->dst = static_cast<int>( node2 );
+                out++;
+                localMin = min( localMin, min( node1, node2 ) );
+                localMax = max( localMax, max( node1, node2 ) );
+            } // for
+
+            chunkMin[c] = localMin;
+            chunkMax[c] = localMax;
+        } // for
+    } );
+
+    unsigned long long globalMin = ULLONG_MAX, globalMax = 0;
+    for ( int i = 0; i < numChunks; i++ ) {
+        if ( chunkIllegal.at(i) ) {
+            cerr << "Error: file illegal, each edge line needs two node IDs." << endl;
+            exit(1);
+        } // if
+
+        globalMin = min( globalMin, chunkMin.at(i) );
+        globalMax = max( globalMax, chunkMax.at(i) );
+    } // for
+
+    if ( globalMax > INT_MAX ) {
+        cerr << "Error: node ID exceeds the int range." << endl;
+        exit(1);
+    } // if
+
+    if ( edgeList.empty() ) {
+        minID = 0;
+        maxID = -1;
+    } // if
+    else {
+        minID = static_cast<int>( globalMin );
+        maxID = static_cast<int>( globalMax );
+    } // else
+} // loadEdgeList
+
+// 讀入 edge list，numOfNodes 設為最大 ID + 1
+inline void loadEdgeList( const string & fileName, EdgeList & edgeList ) {
+    int minID = 0, maxID = -1;
+    loadEdgeList( fileName, edgeList.edges, minID, maxID );
+    edgeList.numOfNodes = maxID + 1;
+} // loadEdgeList
+
+// 輸出檔名：輸入檔名第一個 "." 之前的部分
+inline string outputBaseName( const string & fileName ) {
+    return fileName.substr( 0, fileName.find(".") );
+} // outputBaseName
+
+// 讀文字格式的 CSR：第一行 offsets，第二行 edges，以空白分隔
+template <class EdgeID>
+void readCSR( const string & fileName, BasicCsrGraph<int, EdgeID> & graph ) {
+    ifstream inputFile( fileName );
+    if ( !inputFile ) {
+        cerr << "Error: Unable to open input file." << endl;
+        exit(1);
+    } // if
+
+    vector<EdgeID> csrOffsetArray;
+    vector<int> csrEdgeArray;
+    char ch;
+    EdgeID offset = 0;
+    int edge = 0;
+
+    while( inputFile.get(ch) && ch != '\n' ) {
+        if ( isdigit(ch) )
+            offset = offset * 10 + ( ch - '0' );
+        else if ( ch == ' ' ) {
+            csrOffsetArray.push_back(offset);
+            offset = 0;
+        } // else if
+        else {
+            cout << "file illegal";
+            exit(1);
+        } // else
+    } // while
+
+    while( inputFile.get(ch) ) {
+        if ( isdigit(ch) )
+            edge = edge * 10 + ( ch - '0' );
+        else if ( ch == ' ' ) {
+            csrEdgeArray.push_back(edge);
+            edge = 0;
+        } // else if
+        else {
+            cout << "file illegal";
+            exit(1);
+        } // else
+    } // while
+
+    inputFile.close();
+    graph.adopt( csrOffsetArray, csrEdgeArray );
+} // readCSR
+
+// ---------------------------------------- 快速輸出
+// 各執行緒把自己那段以 to_chars 格式化到自己的緩衝區，主執行緒再依原本的順序整塊 write；
+// 每輪處理 numOfThreads() 段，記憶體用量固定。寫出函式回傳寫出的 bytes，呼叫端可算 MB/s
+
+const size_t WRITE_BLOCK_BYTES = 1 << 22;   // 每個執行緒一次格式化的大小
+const size_t MAX_DIGITS = 20;               // uint64_t 的十進位最多 20 位
+
+// 在 p 寫入 value 的十進位，回傳結尾
+inline char * appendDecimal( char * p, uint64_t value ) {
+    return to_chars( p, p + MAX_DIGITS, value ).ptr;
+} // appendDecimal
+
+inline ofstream openOutputFile( const string & fileName, bool binary = false ) {
+    ofstream outputFile( fileName, binary ? ios::out | ios::binary : ios::out );
+    if ( !outputFile ) {
+        cerr << "Error: Unable to open output file." << endl;
+        exit(1);
+    } // if
+
+    return outputFile;
+} // openOutputFile
+
+inline void closeOutputFile( ofstream & outputFile ) {
+    outputFile.close();
+    if ( !outputFile ) {
+        cerr << "Error: Unable to write output file." << endl;
+        exit(1);
+    } // if
+} // closeOutputFile
+
+// 並行格式化 count 項後依序寫到 output，每項最多 maxItemBytes bytes；
+// format( lo, hi, out ) 把第 lo ~ hi - 1 項寫到 out，回傳寫完的結尾。回傳寫出的 bytes
+template <class Format>
+uint64_t writeFormatted( ostream & output, size_t count, size_t maxItemBytes, Format format ) {
+    int numThreads = numOfThreads();
+    size_t blockItems = max<size_t>( WRITE_BLOCK_BYTES / maxItemBytes, 1 );
+    vector<vector<char>> buffers( numThreads );
+    vector<size_t> lengths( numThreads );
+    uint64_t bytes = 0;
+    for ( size_t begin = 0; begin < count; begin += blockItems * numThreads ) {
+        size_t end = min( count, begin + blockItems * numThreads );
+        fill( lengths.begin(), lengths.end(), 0 );
+        parallelFor( begin, end, [&]( int tid, size_t lo, size_t hi ) {
+            vector<char> & buffer = buffers[tid];
+            if ( buffer.size() < ( hi - lo ) * maxItemBytes )
+                buffer.resize( ( hi - lo ) * maxItemBytes );
+            lengths[tid] = format( lo, hi, buffer.data() ) - buffer.data();
+        } );
+
+        for ( int t = 0; t < numThreads; t++ ) {
+            output.write( buffers[t].data(), lengths[t] );
+            bytes += lengths[t];
+        } // for
+    } // for
+
+    return bytes;
+} // writeFormatted
+
+// 把 CSR 以文字格式寫入 <name>CSR.txt：第一行 offsets，第二行 edges，每個數字後面接一個空白
+template <class EdgeID>
+uint64_t writeCSRFile( const string & fileName, const BasicCsrGraph<int, EdgeID> & graph ) {
+    ofstream outputFile = openOutputFile( outputBaseName( fileName ) + "CSR.txt" );
+    auto formatArray = [&]( const auto * array ) {
+        return [array]( size_t lo, size_t hi, char * out ) {
+            for ( size_t i = lo; i < hi; i++ ) {
+                out = appendDecimal( out, array[i] );
+                *out++ = ' ';
+            } // for
+
+            return out;
+        };
+    };
+
+    uint64_t bytes = writeFormatted( outputFile, graph.numOfNodes + 1, MAX_DIGITS + 1, formatArray( graph.offsets ) );
+    outputFile << "\n";
+    bytes += 1 + writeFormatted( outputFile, graph.numOfEdges, MAX_DIGITS + 1, formatArray( graph.edges ) );
+    closeOutputFile( outputFile );
+    return bytes;
+} // writeCSRFile
+
+// 把 edge list 依目前的順序寫入 <name><oper>.txt，每行 "src dst"
+inline uint64_t writeEdgeListFile( const string & fileName, const EdgeList & edgeList, const string & oper ) {
+    ofstream outputFile = openOutputFile( outputBaseName( fileName ) + oper + ".txt" );
+    const Edge * edge = edgeList.edges.data();
+    uint64_t bytes = writeFormatted( outputFile, edgeList.edges.size(), 2 * MAX_DIGITS + 2, [edge]( size_t lo, size_t hi, char * out ) {
+        for ( size_t i = lo; i < hi; i++ ) {
+            out = appendDecimal( out, edge[i].src );
+            *out++ = ' ';
+            out = appendDecimal( out, edge[i].dst );
+            *out++ = '\n';
+        } // for
+
+        return out;
+    } );
+
+    closeOutputFile( outputFile );
+    return bytes;
+} // writeEdgeListFile
+
+// 第 edge 條邊的來源節點（offsets[src] <= edge < offsets[src + 1]）
+template <class EdgeID>
+int sourceOfEdge( const BasicCsrGraph<int, EdgeID> & graph, EdgeID edge ) {
+    return upper_bound( graph.offsets, graph.offsets + graph.numOfNodes + 1, edge ) - graph.offsets - 1;
+} // sourceOfEdge
+
+// 把 CSR 以 edge list 格式寫入 <name><oper>.txt，依 src 再依 CSR 中鄰居的順序；
+// 依邊切段，每段先以二分搜尋找到第一條邊的 src
+template <class EdgeID>
+uint64_t writeEdgeListFile( const string & fileName, const BasicCsrGraph<int, EdgeID> & graph, const string & oper ) {
+    ofstream outputFile = openOutputFile( outputBaseName( fileName ) + oper + ".txt" );
+    uint64_t bytes = writeFormatted( outputFile, graph.numOfEdges, 2 * MAX_DIGITS + 2, [&]( size_t lo, size_t hi, char * out ) {
+        int u = sourceOfEdge<EdgeID>( graph, lo );
+        for ( size_t e = lo; e < hi; e++ ) {
+            while ( (size_t)graph.offsets[u + 1] <= e )
+                u++;
+            out = appendDecimal( out, u );
+            *out++ = ' ';
+            out = appendDecimal( out, graph.edges[e] );
+            *out++ = '\n';
+        } // for
+
+        return out;
+    } );
+
+    closeOutputFile( outputFile );
+    return bytes;
+} // writeEdgeListFile
+
+// 二進位 edge list 的檔名：<name><oper>_u32.bin 或 <name><oper>_u64.bin
+inline string binaryEdgeListName( const string & fileName, const string & oper, int idBytes ) {
+    return outputBaseName( fileName ) + oper + ( idBytes == 8 ? "_u64.bin" : "_u32.bin" );
+} // binaryEdgeListName
+
+// 把 CSR 寫成二進位 edge list：每條邊為 ( src, dst ) 兩個 idBytes（4 或 8）bytes 的
+// little-endian 無號整數，沒有 header，其他工具可直接 mmap
+template <class EdgeID>
+uint64_t writeBinaryEdgeListFile( const string & outputName, const BasicCsrGraph<int, EdgeID> & graph, int idBytes ) {
+    ofstream outputFile = openOutputFile( outputName, true );
+    uint64_t bytes = writeFormatted( outputFile, graph.numOfEdges, 2 * idBytes, [&]( size_t lo, size_t hi, char * out ) {
+        int u = sourceOfEdge<EdgeID>( graph, lo );
+        for ( size_t e = lo; e < hi; e++ ) {
+            while ( (size_t)graph.offsets[u + 1] <= e )
+                u++;
+            if ( idBytes == 8 ) {
+                uint64_t pair[2] = { (uint64_t)u, (uint64_t)graph.edges[e] };
+                memcpy( out, pair, sizeof( pair ) );
+            } // if
+            else {
+                uint32_t pair[2] = { (uint32_t)u, (uint32_t)graph.edges[e] };
+                memcpy( out, pair, sizeof( pair ) );
+            } // else
+
+            out += 2 * idBytes;
+        } // for
+
+        return out;
+    } );
+
+    closeOutputFile( outputFile );
+    return bytes;
+} // writeBinaryEdgeListFile
+
+// ---------------------------------------- 二進位 CSR 檔
+// 檔案配置（little-endian，各區段對齊 64 bytes）：
+//   CSRFileHeader
+//   offsets     : (numOfNodes + 1) 個 offsetWidth bytes 的整數
+//   edges       : numOfEdges 個 idWidth bytes 的整數
+//   permutation : 選用，numOfNodes 個 idWidth bytes 的整數（舊 ID -> 新 ID）
+// 讀檔時直接 mmap，offsets / edges 指標指向檔案內容，不做解析或複製，只並行檢查一次內容是否合法
+
+const char CSR_FILE_MAGIC[8] = { 'R', 'E', 'O', 'R', 'D', 'C', 'S', 'R' };
+const uint32_t CSR_FILE_VERSION = 1;
+const uint32_t CSR_FLAG_PERMUTATION = 1;
+
+struct CSRFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t idWidth;
+    uint32_t offsetWidth;
+    uint32_t flags;
+    uint64_t numOfNodes;
+    uint64_t numOfEdges;
+    uint64_t offsetsPos;
+    uint64_t edgesPos;
+    uint64_t permutationPos;
+};
+
+static_assert( sizeof( CSRFileHeader ) == 64, "CSRFileHeader must be 64 bytes" );
+
+inline uint64_t alignTo64( uint64_t pos ) {
+    return ( pos + 63 ) / 64 * 64;
+} // alignTo64
+
+// 檔案開頭是否為二進位 CSR 的 magic
+inline bool isCSRBinaryFile( const string & fileName ) {
+    ifstream inputFile( fileName, ios::binary );
+    char magic[8] = { 0 };
+    inputFile.read( magic, sizeof( magic ) );
+    return inputFile && memcmp( magic, CSR_FILE_MAGIC, sizeof( magic ) ) == 0;
+} // isCSRBinaryFile
+
+// 依節點數、邊數填好二進位 CSR 的 header（各區段位置）；offsetWidth 為 4（CsrGraph）或 8（CsrGraph64）
+inline CSRFileHeader makeCSRFileHeader( uint64_t numOfNodes, uint64_t numOfEdges, bool hasPermutation,
+                                        uint32_t offsetWidth = sizeof( int ) ) {
+    CSRFileHeader header;
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.magic, CSR_FILE_MAGIC, sizeof( header.magic ) );
+    header.version = CSR_FILE_VERSION;
+    header.idWidth = sizeof( int );
+    header.offsetWidth = offsetWidth;
+    header.flags = hasPermutation ? CSR_FLAG_PERMUTATION : 0;
+    header.numOfNodes = numOfNodes;
+    header.numOfEdges = numOfEdges;
+    header.offsetsPos = alignTo64( sizeof( header ) );
+    header.edgesPos = alignTo64( header.offsetsPos + ( header.numOfNodes + 1 ) * header.offsetWidth );
+    header.permutationPos = hasPermutation ? alignTo64( header.edgesPos + header.numOfEdges * header.idWidth ) : 0;
+    return header;
+} // makeCSRFileHeader
+
+// 把 CSR 寫成二進位檔，permutation 可為 nullptr；回傳寫出的 bytes
+template <class EdgeID>
+uint64_t writeCSRBinaryFile( const string & fileName, const BasicCsrGraph<int, EdgeID> & graph, const int * permutation = nullptr ) {
+    CSRFileHeader header = makeCSRFileHeader( graph.numOfNodes, graph.numOfEdges, permutation != nullptr, sizeof( EdgeID ) );
+    ofstream outputFile = openOutputFile( fileName, true );
+
+    const char padding[64] = { 0 };
+    uint64_t pos = 0;
+    auto writeSection = [&]( uint64_t sectionPos, const void * data, uint64_t bytes ) {
+        outputFile.write( padding, sectionPos - pos );
+        outputFile.write( static_cast<const char *>( data ), bytes );
+        pos = sectionPos + bytes;
+    };
+
+    EdgeID emptyOffset = 0;
+    writeSection( 0, &header, sizeof( header ) );
+    writeSection( header.offsetsPos, graph.numOfNodes > 0 ? graph.offsets : &emptyOffset,
+                  ( header.numOfNodes + 1 ) * header.offsetWidth );
+    writeSection( header.edgesPos, graph.edges, header.numOfEdges * header.idWidth );
+    if ( permutation != nullptr )
+        writeSection( header.permutationPos, permutation, header.numOfNodes * header.idWidth );
+
+    closeOutputFile( outputFile );
+    return pos;
+} // writeCSRBinaryFile
+
+// mmap 二進位 CSR 檔，graph 的指標直接指向檔案內容
+template <class EdgeID>
+void loadCSRBinaryFile( const string & fileName, BasicCsrGraph<int, EdgeID> & graph ) {
+    shared_ptr<MappedFile> file = make_shared<MappedFile>( fileName );
+    const char * base = file->data();
+
+    CSRFileHeader header;
+    if ( file->size() < sizeof( header ) ) {
+        cerr << "Error: file illegal, CSR header is truncated." << endl;
+        exit(1);
+    } // if
+
+    memcpy( &header, base, sizeof( header ) );
+    if ( memcmp( header.magic, CSR_FILE_MAGIC, sizeof( header.magic ) ) != 0 ) {
+        cerr << "Error: file illegal, not a binary CSR file." << endl;
+        exit(1);
+    } // if
+
+    if ( header.version != CSR_FILE_VERSION ) {
+        cerr << "Error: unsupported CSR file version " << header.version << "." << endl;
+        exit(1);
+    } // if
+
+    if ( header.idWidth != sizeof( int ) || header.offsetWidth != sizeof( EdgeID ) ) {
+        cerr << "Error: unsupported CSR ID width " << header.idWidth << "/" << header.offsetWidth << "." << endl;
+        exit(1);
+    } // if
+
+    if ( header.numOfNodes > INT_MAX || header.numOfEdges > (uint64_t)numeric_limits<EdgeID>::max() ) {
+        cerr << "Error: CSR file is too large for the ID width." << endl;
+        exit(1);
+    } // if
+
+    // 各區段依序排列、互不重疊且都在檔案內（以除法比較，避免壞掉的 header 讓乘法溢位）
+    bool hasPermutation = header.flags & CSR_FLAG_PERMUTATION;
+    uint64_t fileSize = file->size();
+    uint64_t sectionEnd = hasPermutation ? header.permutationPos : fileSize;
+    if ( header.offsetsPos % 64 != 0 || header.edgesPos % 64 != 0 || header.permutationPos % 64 != 0 ||
+         header.offsetsPos < sizeof( header ) || header.edgesPos < header.offsetsPos || sectionEnd < header.edgesPos ||
+         sectionEnd > fileSize ||
+         header.numOfNodes + 1 > ( header.edgesPos - header.offsetsPos ) / header.offsetWidth ||
+         header.numOfEdges > ( sectionEnd - header.edgesPos ) / header.idWidth ||
+         ( hasPermutation && header.numOfNodes > ( fileSize - header.permutationPos ) / header.idWidth ) ) {
+        cerr << "Error: file illegal, CSR sections are out of range." << endl;
+        exit(1);
+    } // if
+
+    graph = BasicCsrGraph<int, EdgeID>();
+    graph.numOfNodes = header.numOfNodes;
+    graph.numOfEdges = header.numOfEdges;
+    graph.offsets = reinterpret_cast<const EdgeID *>( base + header.offsetsPos );
+    graph.edges = reinterpret_cast<const int *>( base + header.edgesPos );
+    if ( hasPermutation )
+        graph.permutation = reinterpret_cast<const int *>( base + header.permutationPos );
+
+    if ( graph.offsets[0] != 0 || graph.offsets[graph.numOfNodes] != graph.numOfEdges ) {
+        cerr << "Error: file illegal, CSR offsets do not match the edge count." << endl;
+        exit(1);
+    } // if
+
+    // kernel 直接信任 mmap 的內容：一次並行檢查 offsets 不遞減、邊的端點與 permutation 都在 [ 0, numOfNodes ) 內，
+    // 每個區塊各檢查一段節點與一段邊
+    int numChunks = numOfThreads();
+    int numNodes = graph.numOfNodes;
+    uint64_t numEdges = graph.numOfEdges;
+    vector<char> chunkIllegal( numChunks, 0 );
+    parallelFor( 0, numChunks, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t c = lo; c < hi; c++ ) {
+            bool illegal = false;
+            int firstNode = (uint64_t)numNodes * c / numChunks, lastNode = (uint64_t)numNodes * ( c + 1 ) / numChunks;
+            for ( int v = firstNode; v < lastNode; v++ ) {
+                illegal |= graph.offsets[v] > graph.offsets[v + 1];
+                if ( hasPermutation )
+                    illegal |= graph.permutation[v] < 0 || graph.permutation[v] >= numNodes;
+            } // for
+
+            uint64_t firstEdge = numEdges / numChunks * c + min<uint64_t>( c, numEdges % numChunks );
+            uint64_t lastEdge = numEdges / numChunks * ( c + 1 ) + min<uint64_t>( c + 1, numEdges % numChunks );
+            for ( uint64_t e = firstEdge; e < lastEdge; e++ )
+                illegal |= graph.edges[e] < 0 || graph.edges[e] >= numNodes;
+
+            chunkIllegal[c] = illegal;
+        } // for
+    } );
+
+    for ( char illegal : chunkIllegal ) {
+        if ( illegal ) {
+            cerr << "Error: file illegal, CSR offsets, edges or permutation are out of range." << endl;
+            exit(1);
+        } // if
+    } // for
+
+    graph.storage = file;
+} // loadCSRBinaryFile
+
+// 讀 CSR：二進位檔直接 mmap，否則當作文字格式解析
+template <class EdgeID>
+void loadCSR( const string & fileName, BasicCsrGraph<int, EdgeID> & graph ) {
+    if ( isCSRBinaryFile( fileName ) )
+        loadCSRBinaryFile( fileName, graph );
+    else
+        readCSR( fileName, graph );
+} // loadCSR
+
+// 讀入圖：二進位 CSR 直接 mmap，否則當作 edge list 建成 CSR
+template <class EdgeID>
+void loadGraph( const string & fileName, BasicCsrGraph<int, EdgeID> & graph ) {
+    if ( isCSRBinaryFile( fileName ) ) {
+        loadCSRBinaryFile( fileName, graph );
+        return;
+    } // if
+
+    EdgeList edgeList;
+    loadEdgeList( fileName, edgeList );
+    if ( needsWideOffsets( edgeList.edges.size() ) && sizeof( EdgeID ) < sizeof( int64_t ) ) {
+        cerr << "Error: graph has more than " << INT_MAX << " edges, use CsrGraph64." << endl;
+        exit(1);
+    } // if
+
+    convertToCSR( edgeList, graph );
+} // loadGraph
+
+// 依輸入大小選擇 offsets 的寬度：邊數在 int 範圍內用 CsrGraph，否則用 CsrGraph64，
+// 再以建好的圖呼叫 func( graph )（func 需同時接受兩種型別，例如 generic lambda）
+template <class Func>
+void withGraph( const string & fileName, Func func ) {
+    if ( isCSRBinaryFile( fileName ) ) {
+        CSRFileHeader header;
+        ifstream inputFile( fileName, ios::binary );
+        inputFile.read( reinterpret_cast<char *>( &header ), sizeof( header ) );
+        if ( header.offsetWidth == sizeof( int64_t ) ) {
+            CsrGraph64 graph;
+            loadCSRBinaryFile( fileName, graph );
+            func( graph );
+        } // if
+        else {
+            CsrGraph graph;
+            loadCSRBinaryFile( fileName, graph );
+            func( graph );
+        } // else
+
+        return;
+    } // if
+
+    EdgeList edgeList;
+    loadEdgeList( fileName, edgeList );
+    if ( needsWideOffsets( edgeList.edges.size() ) ) {
+        CsrGraph64 graph;
+        convertToCSR( edgeList, graph );
+        vector<Edge>().swap( edgeList.edges );
+        func( graph );
+    } // if
+    else {
+        CsrGraph graph;
+        convertToCSR( edgeList, graph );
+        vector<Edge>().swap( edgeList.edges );
+        func( graph );
+    } // else
+} // withGraph
+
+// ---------------------------------------- 二進位 permutation 檔
+// 檔案配置（little-endian，各區段對齊 64 bytes）：
+//   PermutationFileHeader
+//   newID : numOfNodes 個 idWidth bytes 的整數（舊 ID -> 新 ID）
+//   oldID : numOfNodes 個 idWidth bytes 的整數（新 ID -> 舊 ID）
+// 兩個方向都存下來，另一邊的資料（特徵、標籤）不論往哪個方向換都不必再算反函數
+
+const char PERMUTATION_FILE_MAGIC[8] = { 'R', 'E', 'O', 'R', 'D', 'P', 'R', 'M' };
+const uint32_t PERMUTATION_FILE_VERSION = 1;
+
+struct PermutationFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t idWidth;
+    uint64_t numOfNodes;
+    uint64_t newIDPos;
+    uint64_t oldIDPos;
+    uint64_t reserved[3];
+};
+
+static_assert( sizeof( PermutationFileHeader ) == 64, "PermutationFileHeader must be 64 bytes" );
+
+// permutation 檔的檔名：<name><oper>_perm.bin
+inline string permutationFileName( const string & fileName, const string & oper ) {
+    return outputBaseName( fileName ) + oper + "_perm.bin";
+} // permutationFileName
+
+// 把 newID（長度 numOfNodes）與它的反函數寫成 permutation 檔；回傳寫出的 bytes
+inline uint64_t writePermutationFile( const string & fileName, const int * newID, int numOfNodes ) {
+    vector<int> oldID( numOfNodes );
+    parallelFor( 0, numOfNodes, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t v = lo; v < hi; v++ )
+            oldID[newID[v]] = v;
+    } );
+
+    PermutationFileHeader header;
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.magic, PERMUTATION_FILE_MAGIC, sizeof( header.magic ) );
+    header.version = PERMUTATION_FILE_VERSION;
+    header.idWidth = sizeof( int );
+    header.numOfNodes = numOfNodes;
+    header.newIDPos = alignTo64( sizeof( header ) );
+    header.oldIDPos = alignTo64( header.newIDPos + header.numOfNodes * header.idWidth );
+
+    ofstream outputFile = openOutputFile( fileName, true );
+    const char padding[64] = { 0 };
+    uint64_t pos = 0;
+    auto writeSection = [&]( uint64_t sectionPos, const void * data, uint64_t bytes ) {
+        outputFile.write( padding, sectionPos - pos );
+        outputFile.write( static_cast<const char *>( data ), bytes );
+        pos = sectionPos + bytes;
+    };
+
+    writeSection( 0, &header, sizeof( header ) );
+    writeSection( header.newIDPos, newID, header.numOfNodes * header.idWidth );
+    writeSection( header.oldIDPos, oldID.data(), header.numOfNodes * header.idWidth );
+    closeOutputFile( outputFile );
+    return pos;
+} // writePermutationFile
+
+inline uint64_t writePermutationFile( const string & fileName, const Permutation & permutation ) {
+    return writePermutationFile( fileName, permutation.newID.data(), permutation.size() );
+} // writePermutationFile
+
+// 讀 permutation 檔，oldID 不為 nullptr 時一併讀出反函數；檢查兩個方向互為反函數
+inline void loadPermutationFile( const string & fileName, Permutation & permutation, vector<int> * oldID = nullptr ) {
+    MappedFile file( fileName );
+    PermutationFileHeader header;
+    if ( file.size() < sizeof( header ) ) {
+        cerr << "Error: file illegal, permutation header is truncated." << endl;
+        exit(1);
+    } // if
+
+    memcpy( &header, file.data(), sizeof( header ) );
+    if ( memcmp( header.magic, PERMUTATION_FILE_MAGIC, sizeof( header.magic ) ) != 0 ) {
+        cerr << "Error: file illegal, not a permutation file." << endl;
+        exit(1);
+    } // if
+
+    if ( header.version != PERMUTATION_FILE_VERSION || header.idWidth != sizeof( int ) ) {
+        cerr << "Error: unsupported permutation file version " << header.version << "." << endl;
+        exit(1);
+    } // if
+
+    // 兩段依序為 newID、oldID，不重疊且都在檔案內（以減法、除法比較，避免加法溢位）
+    if ( header.numOfNodes > (uint64_t)INT_MAX || header.newIDPos < sizeof( header ) || header.oldIDPos < header.newIDPos ||
+         header.oldIDPos - header.newIDPos < header.numOfNodes * header.idWidth || header.oldIDPos > file.size() ||
+         header.numOfNodes > ( file.size() - header.oldIDPos ) / header.idWidth ) {
+        cerr << "Error: file illegal, permutation sections are out of range." << endl;
+        exit(1);
+    } // if
+
+    int numNodes = header.numOfNodes;
+    const int * newID = reinterpret_cast<const int *>( file.data() + header.newIDPos );
+    const int * inverse = reinterpret_cast<const int *>( file.data() + header.oldIDPos );
+    vector<char> illegal( numOfThreads(), 0 );
+    parallelFor( 0, numNodes, [&]( int tid, size_t lo, size_t hi ) {
+        for ( size_t v = lo; v < hi; v++ ) {
+            if ( newID[v] < 0 || newID[v] >= numNodes || inverse[newID[v]] != (int)v )
+                illegal[tid] = 1;
+        } // for
+    } );
+
+    if ( find( illegal.begin(), illegal.end(), 1 ) != illegal.end() ) {
+        cerr << "Error: file illegal, not a valid permutation." << endl;
+        exit(1);
+    } // if
+
+    permutation.newID.assign( newID, newID + numNodes );
+    if ( oldID != nullptr )
+        oldID->assign( inverse, inverse + numNodes );
+} // loadPermutationFile
+
+// 以 permutation 重新排列每個節點一筆、每筆 recordBytes 的資料檔（特徵矩陣、標籤等）：
+// 開頭 headerBytes 原樣複製，之後輸出的第 i 筆為輸入的第 source[ i ] 筆
+// （source 為 oldID 時由原編號換成新編號，為 newID 時換回原編號）。
+// 輸入以 mmap 隨機讀取，輸出經 writeFormatted 分塊並行複製後循序寫出，記憶體只需固定大小的緩衝區。
+// 回傳寫出的 bytes
+inline uint64_t permuteVertexData( const string & inputName, const string & outputName, const vector<int> & source,
+                                   size_t recordBytes, size_t headerBytes = 0 ) {
+    MappedFile file( inputName );
+    if ( recordBytes == 0 || file.size() != headerBytes + source.size() * recordBytes ) {
+        cerr << "Error: data file size does not match " << source.size() << " records of " << recordBytes << " bytes." << endl;
+        exit(1);
+    } // if
+
+    file.advise( MADV_RANDOM );
+    const char * records = file.data() + headerBytes;
+    ofstream outputFile = openOutputFile( outputName, true );
+    outputFile.write( file.data(), headerBytes );
+    uint64_t bytes = headerBytes + writeFormatted( outputFile, source.size(), recordBytes, [&]( size_t lo, size_t hi, char * out ) {
+        for ( size_t i = lo; i < hi; i++, out += recordBytes )
+            memcpy( out, records + (size_t)source[i] * recordBytes, recordBytes );
+        return out;
+    } );
+
+    closeOutputFile( outputFile );
+    return bytes;
+} // permuteVertexData
+
+#endif // GRAPH_IO_H
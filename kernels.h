@@ -0,0 +1,233 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "graph.h"
+#include "parallel.h"
+
+using namespace std;
+
+// ---------------------------------------- 圖分析 kernel（評估 reordering 的效果用）
+// 全部並行，輸入都是 CsrGraph；需要入邊或無向圖時由呼叫端先建好
+
+const double PAGERANK_DAMPING = 0.85;
+
+// 邊權重 1 ~ 255，由原始 ID 決定，因此在任何 reordering 下同一條邊的權重都相同
+inline int edgeWeight( int src, int dst ) {
+    uint64_t x = ( (uint64_t)(uint32_t)src << 32 ) | (uint32_t)dst;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return 1 + x % 255;
+} // edgeWeight
+
+// 重新編號後的圖的邊權重（與 graph.edges 對齊）；oldID[ 新 ID ] = 舊 ID
+inline vector<int> originalEdgeWeights( const CsrGraph & graph, const vector<int> & oldID ) {
+    vector<int> weight( graph.numOfEdges );
+    parallelFor( 0, graph.numOfNodes, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t u = lo; u < hi; u++ ) {
+            for ( int e = graph.offsets[u]; e < graph.offsets[u + 1]; e++ )
+                weight[e] = edgeWeight( oldID[u], oldID[graph.edges[e]] );
+        } // for
+    } );
+
+    return weight;
+} // originalEdgeWeights
+
+// PageRank（pull）：每個節點從入鄰居收集 rank / out-degree，固定做 iterations 輪
+inline vector<double> pageRankPull( const CsrGraph & graph, const CsrGraph & inGraph, int iterations ) {
+    int numNodes = graph.numOfNodes;
+    double base = ( 1.0 - PAGERANK_DAMPING ) / max( numNodes, 1 );
+    vector<double> rank( numNodes, 1.0 / max( numNodes, 1 ) );
+    vector<double> contribution( numNodes );
+
+    for ( int iter = 0; iter < iterations; iter++ ) {
+        parallelFor( 0, numNodes, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t u = lo; u < hi; u++ ) {
+                int degree = graph.degree( u );
+                contribution[u] = degree > 0 ? rank[u] / degree : 0;
+            } // for
+        } );
+
+        parallelForDynamic( 0, numNodes, 1024, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t v = lo; v < hi; v++ ) {
+                double sum = 0;
+                for ( int e = inGraph.offsets[v]; e < inGraph.offsets[v + 1]; e++ )
+                    sum += contribution[inGraph.edges[e]];
+                rank[v] = base + PAGERANK_DAMPING * sum;
+            } // for
+        } );
+    } // for
+
+    return rank;
+} // pageRankPull
+
+// PageRank（push）：每個節點把 rank / out-degree 以 atomic 加到出鄰居
+inline vector<double> pageRankPush( const CsrGraph & graph, int iterations ) {
+    int numNodes = graph.numOfNodes;
+    double base = ( 1.0 - PAGERANK_DAMPING ) / max( numNodes, 1 );
+    vector<double> rank( numNodes, 1.0 / max( numNodes, 1 ) );
+    unique_ptr<atomic<double>[]> sum( new atomic<double>[numNodes] );
+
+    for ( int iter = 0; iter < iterations; iter++ ) {
+        parallelFor( 0, numNodes, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t v = lo; v < hi; v++ )
+                sum[v].store( 0, memory_order_relaxed );
+        } );
+
+        parallelForDynamic( 0, numNodes, 1024, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t u = lo; u < hi; u++ ) {
+                int degree = graph.degree( u );
+                if ( degree == 0 )
+                    continue;
+
+                double contribution = rank[u] / degree;
+                for ( int e = graph.offsets[u]; e < graph.offsets[u + 1]; e++ ) {
+                    atomic<double> & target = sum[graph.edges[e]];
+                    double current = target.load( memory_order_relaxed );
+                    while ( !target.compare_exchange_weak( current, current + contribution, memory_order_relaxed ) ) {
+                    } // while
+                } // for
+            } // for
+        } );
+
+        parallelFor( 0, numNodes, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t v = lo; v < hi; v++ )
+                rank[v] = base + PAGERANK_DAMPING * sum[v].load( memory_order_relaxed );
+        } );
+    } // for
+
+    return rank;
+} // pageRankPush
+
+// delta-stepping SSSP：weight 與 graph.edges 對齊，無法到達的節點距離為 INT_MAX
+// 各執行緒把鬆弛成功的節點放進自己的 bucket（距離 / delta），
+// 每一輪取所有執行緒中編號最小的非空 bucket 當 frontier
+inline vector<int> deltaSteppingSSSP( const CsrGraph & graph, const vector<int> & weight, int source, int delta ) {
+    int numNodes = graph.numOfNodes;
+    int numThreads = numOfThreads();
+    unique_ptr<atomic<int>[]> dist( new atomic<int>[numNodes] );
+    parallelFor( 0, numNodes, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t v = lo; v < hi; v++ )
+            dist[v].store( INT_MAX, memory_order_relaxed );
+    } );
+
+    vector<vector<vector<int>>> localBins( numThreads );
+    vector<int> frontier;
+    if ( source >= 0 && source < numNodes ) {
+        dist[source].store( 0, memory_order_relaxed );
+        frontier.push_back( source );
+    } // if
+
+    size_t bin = 0;
+    while ( !frontier.empty() ) {
+        parallelForDynamic( 0, frontier.size(), 64, [&]( int tid, size_t lo, size_t hi ) {
+            vector<vector<int>> & bins = localBins[tid];
+            for ( size_t i = lo; i < hi; i++ ) {
+                int u = frontier[i];
+                int distU = dist[u].load( memory_order_relaxed );
+
+                // 已經被更短的距離取代，之後會在較前面的 bucket 處理過
+                if ( (size_t)distU < bin * delta )
+                    continue;
+
+                for ( int e = graph.offsets[u]; e < graph.offsets[u + 1]; e++ ) {
+                    int v = graph.edges[e];
+                    int newDist = distU + weight[e];
+                    int current = dist[v].load( memory_order_relaxed );
+                    while ( newDist < current ) {
+                        if ( dist[v].compare_exchange_weak( current, newDist, memory_order_relaxed ) ) {
+                            size_t target = newDist / delta;
+                            if ( target >= bins.size() )
+                                bins.resize( target + 1 );
+                            bins[target].push_back( v );
+                            break;
+                        } // if
+                    } // while
+                } // for
+            } // for
+        } );
+
+        // 下一個 bucket：所有執行緒中最小的非空 bucket（可能還是同一個）
+        size_t next = SIZE_MAX;
+        for ( auto & bins : localBins ) {
+            for ( size_t b = bin; b < bins.size() && b < next; b++ ) {
+                if ( !bins[b].empty() ) {
+                    next = b;
+                    break;
+                } // if
+            } // for
+        } // for
+
+        frontier.clear();
+        if ( next == SIZE_MAX )
+            break;
+
+        for ( auto & bins : localBins ) {
+            if ( next < bins.size() ) {
+                frontier.insert( frontier.end(), bins[next].begin(), bins[next].end() );
+                bins[next].clear();
+            } // if
+        } // for
+
+        bin = next;
+    } // while
+
+    vector<int> result( numNodes );
+    parallelFor( 0, numNodes, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t v = lo; v < hi; v++ )
+            result[v] = dist[v].load( memory_order_relaxed );
+    } );
+
+    return result;
+} // deltaSteppingSSSP
+
+// label propagation 連通元件：undirected 為無向化的圖，
+// 每個節點反覆取自己與鄰居中最小的 label，直到沒有變化；回傳 label，iterations 為輪數
+inline vector<int> labelPropagationCC( const CsrGraph & undirected, int & iterations ) {
+    int numNodes = undirected.numOfNodes;
+    unique_ptr<atomic<int>[]> label( new atomic<int>[numNodes] );
+    parallelFor( 0, numNodes, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t v = lo; v < hi; v++ )
+            label[v].store( v, memory_order_relaxed );
+    } );
+
+    iterations = 0;
+    atomic<bool> changed( true );
+    while ( changed.load() ) {
+        changed.store( false );
+        iterations++;
+        parallelForDynamic( 0, numNodes, 1024, [&]( int, size_t lo, size_t hi ) {
+            bool localChanged = false;
+            for ( size_t v = lo; v < hi; v++ ) {
+                int minimum = label[v].load( memory_order_relaxed );
+                for ( int e = undirected.offsets[v]; e < undirected.offsets[v + 1]; e++ )
+                    minimum = min( minimum, label[undirected.edges[e]].load( memory_order_relaxed ) );
+
+                if ( minimum < label[v].load( memory_order_relaxed ) ) {
+                    label[v].store( minimum, memory_order_relaxed );
+                    localChanged = true;
+                } // if
+            } // for
+
+            if ( localChanged )
+                changed.store( true, memory_order_relaxed );
+        } );
+    } // while
+
+    vector<int> result( numNodes );
+    parallelFor( 0, numNodes, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t v = lo; v < hi; v++ )
+            result[v] = label[v].load( memory_order_relaxed );
+    } );
+
+    return result;
+} // labelPropagationCC
+
+#endif // KERNELS_H
@@ -0,0 +1,196 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "graph.h"
+#include "parallel.h"
+
+using namespace std;
+
+// 把圖看成鄰接矩陣（第 u 列第 v 行有非零元素表示 u -> v）的形狀
+//   bandwidth : max | i - j |，( i, j ) 為非零元素
+//   profile   : 對稱化後的下三角包絡大小，Σ ( i - 第 i 列最左邊非零元素的行 )
+struct MatrixShape {
+    long long bandwidth = 0;
+    long long profile = 0;
+};
+
+// permutation 為 nullptr 時量目前的編號，否則量重新編號後的矩陣（不必真的套用）
+template <class EdgeID>
+MatrixShape matrixShape( const BasicCsrGraph<int, EdgeID> & graph, const Permutation * permutation = nullptr ) {
+    int numNodes = graph.numOfNodes;
+    const int * newID = permutation != nullptr ? permutation->newID.data() : nullptr;
+    auto idOf = [newID]( int v ) { return newID != nullptr ? newID[v] : v; };
+
+    // first[i]：第 i 列（含對稱位置）最左邊的行，初始為 i
+    unique_ptr<atomic<int>[]> first( new atomic<int>[numNodes] );
+    parallelFor( 0, numNodes, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t i = lo; i < hi; i++ )
+            first[i].store( i, memory_order_relaxed );
+    } );
+
+    vector<long long> threadBandwidth( numOfThreads(), 0 );
+    parallelFor( 0, numNodes, [&]( int tid, size_t lo, size_t hi ) {
+        long long bandwidth = 0;
+        for ( size_t u = lo; u < hi; u++ ) {
+            int i = idOf( u );
+            for ( EdgeID e = graph.offsets[u]; e < graph.offsets[u + 1]; e++ ) {
+                int j = idOf( graph.edges[e] );
+                int row = max( i, j ), column = min( i, j );
+                bandwidth = max<long long>( bandwidth, row - column );
+
+                int current = first[row].load( memory_order_relaxed );
+                while ( column < current &&
+                        !first[row].compare_exchange_weak( current, column, memory_order_relaxed ) ) {
+                } // while
+            } // for
+        } // for
+
+        threadBandwidth[tid] = bandwidth;
+    } );
+
+    vector<long long> threadProfile( numOfThreads(), 0 );
+    parallelFor( 0, numNodes, [&]( int tid, size_t lo, size_t hi ) {
+        long long profile = 0;
+        for ( size_t i = lo; i < hi; i++ )
+            profile += i - first[i].load( memory_order_relaxed );
+        threadProfile[tid] = profile;
+    } );
+
+    MatrixShape shape;
+    for ( long long bandwidth : threadBandwidth )
+        shape.bandwidth = max( shape.bandwidth, bandwidth );
+    for ( long long profile : threadProfile )
+        shape.profile += profile;
+
+    return shape;
+} // matrixShape
+
+// ---------------------------------------- 區域性指標
+// 一次並行掃過每一列的鄰居（依新 ID 排序後）統計：
+//   averageGap / averageLogGap : 同一列相鄰鄰居的 ID 差與 log2( 1 + 差 )，壓縮與存取跳躍的指標
+//   averageEdgeSpan            : 平均 | u - v |
+//   bandwidth / profile        : 同 matrixShape
+//   cacheLineShare             : 鄰居與同一列前一個鄰居的屬性落在同一條 64 bytes cache line 的比例
+//   hubConcentration[k]        : 落在新 ID 前 ( k + 1 )% 節點的邊（目的端）佔全部邊的比例
+const int CACHE_LINE_BYTES = 64;
+const int HUB_CURVE_POINTS = 100;
+
+struct LocalityMetrics {
+    double averageGap = 0;
+    double averageLogGap = 0;
+    double averageEdgeSpan = 0;
+    long long bandwidth = 0;
+    long long profile = 0;
+    double cacheLineShare = 0;
+    vector<double> hubConcentration;
+};
+
+// propertyBytes 為每個節點屬性的大小（例如 PageRank 的 double 為 8）
+inline LocalityMetrics localityMetrics( const CsrGraph & graph, const Permutation * permutation = nullptr,
+                                        int propertyBytes = 4 ) {
+    int numNodes = graph.numOfNodes;
+    int numThreads = numOfThreads();
+    const int * newID = permutation != nullptr ? permutation->newID.data() : nullptr;
+    int nodesPerLine = max( 1, CACHE_LINE_BYTES / propertyBytes );
+
+    unique_ptr<atomic<int>[]> first( new atomic<int>[numNodes] );
+    parallelFor( 0, numNodes, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t i = lo; i < hi; i++ )
+            first[i].store( i, memory_order_relaxed );
+    } );
+
+    // 各執行緒的累計值
+    struct Partial {
+        double gapSum = 0, logGapSum = 0, spanSum = 0;
+        long long gapCount = 0, shared = 0, bandwidth = 0;
+        vector<long long> hub;
+    };
+    vector<Partial> partial( numThreads );
+
+    parallelForDynamic( 0, numNodes, 1024, [&]( int tid, size_t lo, size_t hi ) {
+        Partial & p = partial[tid];
+        p.hub.resize( HUB_CURVE_POINTS, 0 );
+        vector<int> row;
+        for ( size_t u = lo; u < hi; u++ ) {
+            int i = newID != nullptr ? newID[u] : u;
+            row.clear();
+            for ( int e = graph.offsets[u]; e < graph.offsets[u + 1]; e++ )
+                row.push_back( newID != nullptr ? newID[graph.edges[e]] : graph.edges[e] );
+            if ( !is_sorted( row.begin(), row.end() ) )
+                sort( row.begin(), row.end() );
+
+            for ( size_t k = 0; k < row.size(); k++ ) {
+                int j = row[k];
+                int span = abs( i - j );
+                p.spanSum += span;
+                p.bandwidth = max<long long>( p.bandwidth, span );
+                p.hub[(long long)j * HUB_CURVE_POINTS / numNodes]++;
+
+                int r = max( i, j ), c = min( i, j );
+                int current = first[r].load( memory_order_relaxed );
+                while ( c < current && !first[r].compare_exchange_weak( current, c, memory_order_relaxed ) ) {
+                } // while
+
+                if ( k > 0 ) {
+                    int gap = j - row[k - 1];
+                    p.gapSum += gap;
+                    p.logGapSum += log2( 1.0 + gap );
+                    p.gapCount++;
+                    if ( j / nodesPerLine == row[k - 1] / nodesPerLine )
+                        p.shared++;
+                } // if
+            } // for
+        } // for
+    } );
+
+    LocalityMetrics metrics;
+    double gapSum = 0, logGapSum = 0, spanSum = 0;
+    long long gapCount = 0, shared = 0;
+    vector<long long> hub( HUB_CURVE_POINTS, 0 );
+    for ( const Partial & p : partial ) {
+        gapSum += p.gapSum;
+        logGapSum += p.logGapSum;
+        spanSum += p.spanSum;
+        gapCount += p.gapCount;
+        shared += p.shared;
+        metrics.bandwidth = max( metrics.bandwidth, p.bandwidth );
+        for ( size_t k = 0; k < p.hub.size(); k++ )
+            hub[k] += p.hub[k];
+    } // for
+
+    vector<long long> threadProfile( numThreads, 0 );
+    parallelFor( 0, numNodes, [&]( int tid, size_t lo, size_t hi ) {
+        long long profile = 0;
+        for ( size_t i = lo; i < hi; i++ )
+            profile += i - first[i].load( memory_order_relaxed );
+        threadProfile[tid] = profile;
+    } );
+    for ( long long profile : threadProfile )
+        metrics.profile += profile;
+
+    if ( gapCount > 0 ) {
+        metrics.averageGap = gapSum / gapCount;
+        metrics.averageLogGap = logGapSum / gapCount;
+        metrics.cacheLineShare = (double)shared / gapCount;
+    } // if
+    if ( graph.numOfEdges > 0 )
+        metrics.averageEdgeSpan = spanSum / graph.numOfEdges;
+
+    metrics.hubConcentration.resize( HUB_CURVE_POINTS, 0 );
+    long long running = 0;
+    for ( int k = 0; k < HUB_CURVE_POINTS; k++ ) {
+        running += hub[k];
+        metrics.hubConcentration[k] = graph.numOfEdges > 0 ? (double)running / graph.numOfEdges : 0;
+    } // for
+
+    return metrics;
+} // localityMetrics
+
+#endif // METRICS_H
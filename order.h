@@ -0,0 +1,455 @@
+#ifndef ORDER_H
+#define ORDER_H
+
+#include <iostream>
+#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "graph.h"
+#include "parallel.h"
+#include "traversal.h"
+
+using namespace std;
+
+// 所有 reordering 的共同介面：由 CSR 算出新的編號
+class Ordering {
+public:
+    virtual ~Ordering() = default;
+
+    // 名稱，輸出檔名為 <name>_<名稱>.txt
+    virtual string name() const = 0;
+    virtual Permutation compute( const CsrGraph & graph ) const = 0;
+
+    // 邊數超過 INT_MAX 的圖（64 位元 offsets），只有 degree 系列、Original、Random 支援
+    virtual Permutation compute( const CsrGraph64 & ) const {
+        cerr << "Error: " << name() << " does not support graphs with more than " << INT_MAX << " edges." << endl;
+        exit(1);
+    } // compute
+};
+
+// 排序依據的 degree
+enum DegreeType {
+    IN_DEGREE,
+    OUT_DEGREE,
+    TOTAL_DEGREE
+};
+
+// 輸出檔名用的後綴，in-degree 為預設所以沒有後綴
+inline string degreeTypeSuffix( DegreeType type ) {
+    if ( type == OUT_DEGREE )
+        return "Out";
+    if ( type == TOTAL_DEGREE )
+        return "Total";
+    return "";
+} // degreeTypeSuffix
+
+// 紀錄每個 node 的 degree
+template <class EdgeID>
+vector<int> countDegree( const BasicCsrGraph<int, EdgeID> & graph, DegreeType type ) {
+    int numNodes = graph.numOfNodes;
+    vector<int> degree( numNodes, 0 );
+    if ( type != OUT_DEGREE ) {
+        unique_ptr<atomic<int>[]> inDegree( new atomic<int>[numNodes] );
+        parallelFor( 0, numNodes, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t v = lo; v < hi; v++ )
+                inDegree[v].store( 0, memory_order_relaxed );
+        } );
+        parallelFor( 0, graph.numOfEdges, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t e = lo; e < hi; e++ )
+                inDegree[graph.edges[e]].fetch_add( 1, memory_order_relaxed );
+        } );
+        parallelFor( 0, numNodes, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t v = lo; v < hi; v++ )
+                degree[v] = inDegree[v].load( memory_order_relaxed );
+        } );
+    } // if
+
+    if ( type != IN_DEGREE ) {
+        parallelFor( 0, numNodes, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t v = lo; v < hi; v++ )
+                degree[v] += graph.degree( v );
+        } );
+    } // if
+
+    return degree;
+} // countDegree
+
+// 節點依 key 由小到大穩定排序，回傳排好的節點 ID；key 介於 0 ~ numKeys - 1
+// key 範圍大時拆成兩輪 16 位元的 radix sort，直方圖不會太大
+inline vector<int> sortByKey( const vector<int> & key, int numKeys ) {
+    vector<int> order( key.size() );
+    for ( size_t v = 0; v < key.size(); v++ )
+        order[v] = v;
+
+    const int digitBits = 16;
+    if ( numKeys <= ( 1 << digitBits ) )
+        return parallelCountingSort( order, max( numKeys, 1 ), [&]( int v ) { return key[v]; } );
+
+    order = parallelCountingSort( order, 1 << digitBits, [&]( int v ) { return key[v] & ( ( 1 << digitBits ) - 1 ); } );
+    return parallelCountingSort( order, ( numKeys >> digitBits ) + 1, [&]( int v ) { return key[v] >> digitBits; } );
+} // sortByKey
+
+// 平均 degree（不取整數）
+inline double averageDegree( const vector<int> & degree ) {
+    vector<long long> threadSum( numOfThreads(), 0 );
+    parallelFor( 0, degree.size(), [&]( int tid, size_t lo, size_t hi ) {
+        long long sum = 0;
+        for ( size_t v = lo; v < hi; v++ )
+            sum += degree[v];
+        threadSum[tid] = sum;
+    } );
+
+    long long total = 0;
+    for ( long long sum : threadSum )
+        total += sum;
+    return degree.empty() ? 0 : (double)total / degree.size();
+} // averageDegree
+
+inline int maxDegree( const vector<int> & degree ) {
+    vector<int> threadMax( numOfThreads(), 0 );
+    parallelFor( 0, degree.size(), [&]( int tid, size_t lo, size_t hi ) {
+        int localMax = 0;
+        for ( size_t v = lo; v < hi; v++ )
+            localMax = max( localMax, degree[v] );
+        threadMax[tid] = localMax;
+    } );
+
+    return *max_element( threadMax.begin(), threadMax.end() );
+} // maxDegree
+
+// degree 系列的共同部分：算 degree，再依 key 做 counting sort
+// 子類別只決定每個節點的 key，同 key 的節點維持原本的 ID 順序
+class DegreeOrdering : public Ordering {
+public:
+    explicit DegreeOrdering( DegreeType type ) : type( type ) {}
+
+    Permutation compute( const CsrGraph & graph ) const override {
+        return computeFromDegrees( countDegree( graph, type ) );
+    } // compute
+
+    Permutation compute( const CsrGraph64 & graph ) const override {
+        return computeFromDegrees( countDegree( graph, type ) );
+    } // compute
+
+    // 只需要 degree 陣列，不需要整張圖（外部記憶體模式使用）
+    Permutation computeFromDegrees( const vector<int> & degree ) const {
+        vector<int> key( degree.size() );
+        int numKeys = assignKeys( degree, key );
+        return permutationFromOrder( sortByKey( key, numKeys ), degree.size() );
+    } // computeFromDegrees
+
+    DegreeType degreeType() const { return type; }
+
+protected:
+    DegreeType type;
+
+    // 填入 key，回傳 key 的種類數
+    virtual int assignKeys( const vector<int> & degree, vector<int> & key ) const = 0;
+};
+
+// 不改變編號，作為比較的基準
+class OriginalOrder : public Ordering {
+public:
+    string name() const override { return "Original"; }
+
+    Permutation compute( const CsrGraph & graph ) const override {
+        return identity( graph.numOfNodes );
+    } // compute
+
+    Permutation compute( const CsrGraph64 & graph ) const override {
+        return identity( graph.numOfNodes );
+    } // compute
+
+private:
+    static Permutation identity( int numOfNodes ) {
+        Permutation permutation;
+        permutation.newID.resize( numOfNodes );
+        parallelFor( 0, numOfNodes, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t v = lo; v < hi; v++ )
+                permutation.newID[v] = v;
+        } );
+
+        return permutation;
+    } // identity
+};
+
+// 隨機打亂，固定 seed 以便重現
+class RandomOrder : public Ordering {
+public:
+    explicit RandomOrder( unsigned seed = 0 ) : seed( seed ) {}
+
+    string name() const override { return "Random"; }
+
+    Permutation compute( const CsrGraph & graph ) const override {
+        return shuffled( graph.numOfNodes );
+    } // compute
+
+    Permutation compute( const CsrGraph64 & graph ) const override {
+        return shuffled( graph.numOfNodes );
+    } // compute
+
+private:
+    unsigned seed;
+
+    Permutation shuffled( int numOfNodes ) const {
+        Permutation permutation;
+        permutation.newID.resize( numOfNodes );
+        for ( int i = 0; i < numOfNodes; i++ )
+            permutation.newID[i] = i;
+
+        shuffle( permutation.newID.begin(), permutation.newID.end(), default_random_engine( seed ) );
+        return permutation;
+    } // shuffled
+};
+
+// 依 degree 由大到小重新編號
+class DegreeSort : public DegreeOrdering {
+public:
+    explicit DegreeSort( DegreeType type = IN_DEGREE ) : DegreeOrdering( type ) {}
+
+    string name() const override { return "DegreeSort" + degreeTypeSuffix( type ); }
+
+protected:
+    int assignKeys( const vector<int> & degree, vector<int> & key ) const override {
+        int maximum = maxDegree( degree );
+        parallelFor( 0, degree.size(), [&]( int, size_t lo, size_t hi ) {
+            for ( size_t v = lo; v < hi; v++ )
+                key[v] = maximum - degree[v];
+        } );
+
+        return maximum + 1;
+    } // assignKeys
+};
+
+// degree 大於平均的 hub 依 degree 由大到小排在前面，其餘節點維持原本順序接在後面
+class HubSort : public DegreeOrdering {
+public:
+    explicit HubSort( DegreeType type = IN_DEGREE ) : DegreeOrdering( type ) {}
+
+    string name() const override { return "HubSort" + degreeTypeSuffix( type ); }
+
+protected:
+    int assignKeys( const vector<int> & degree, vector<int> & key ) const override {
+        double average = averageDegree( degree );
+        int maximum = maxDegree( degree );
+        parallelFor( 0, degree.size(), [&]( int, size_t lo, size_t hi ) {
+            for ( size_t v = lo; v < hi; v++ )
+                key[v] = degree[v] > average ? maximum - degree[v] : maximum + 1;
+        } );
+
+        return maximum + 2;
+    } // assignKeys
+};
+
+// degree 大於平均的 hot 節點排在前面，其餘 cold 節點在後，各自維持原本順序
+class HubCluster : public DegreeOrdering {
+public:
+    explicit HubCluster( DegreeType type = IN_DEGREE ) : DegreeOrdering( type ) {}
+
+    string name() const override { return "HubCluster" + degreeTypeSuffix( type ); }
+
+protected:
+    int assignKeys( const vector<int> & degree, vector<int> & key ) const override {
+        double average = averageDegree( degree );
+        parallelFor( 0, degree.size(), [&]( int, size_t lo, size_t hi ) {
+            for ( size_t v = lo; v < hi; v++ )
+                key[v] = degree[v] > average ? 0 : 1;
+        } );
+
+        return 2;
+    } // assignKeys
+};
+
+// Degree-Based Grouping：依 degree 分組，degree 高的組在前，組內維持原本順序
+// boundaries 為遞增的 degree 門檻，degree 在 [ boundaries[k - 1], boundaries[k] ) 的節點屬於第 k 組；
+// 沒有指定時使用平均 degree 的 1/2、1、2、4、8、16、32 倍
+class DBG : public DegreeOrdering {
+public:
+    explicit DBG( DegreeType type = IN_DEGREE, const vector<double> & boundaries = vector<double>() )
+        : DegreeOrdering( type ), boundaries( boundaries ) {}
+
+    string name() const override { return "DBG" + degreeTypeSuffix( type ); }
+
+protected:
+    int assignKeys( const vector<int> & degree, vector<int> & key ) const override {
+        vector<double> bound = boundaries;
+        if ( bound.empty() ) {
+            double average = averageDegree( degree );
+            for ( double scale = 0.5; scale <= 32; scale *= 2 )
+                bound.push_back( average * scale );
+        } // if
+
+        sort( bound.begin(), bound.end() );
+        int numGroups = bound.size() + 1;
+        parallelFor( 0, degree.size(), [&]( int, size_t lo, size_t hi ) {
+            for ( size_t v = lo; v < hi; v++ ) {
+                int group = upper_bound( bound.begin(), bound.end(), (double)degree[v] ) - bound.begin();
+                key[v] = numGroups - 1 - group;
+            } // for
+        } );
+
+        return numGroups;
+    } // assignKeys
+
+private:
+    vector<double> boundaries;
+};
+
+// 依 BFS 拜訪順序編號，沒拜訪到的節點接在後面
+// inGraph 為入邊 CSR，提供時 BFS 才能使用 bottom-up
+class BFSOrder : public Ordering {
+public:
+    explicit BFSOrder( int startNode = 0, const CsrGraph * inGraph = nullptr )
+        : startNode( startNode ), inGraph( inGraph ) {}
+
+    string name() const override { return "bfsOrder"; }
+
+    Permutation compute( const CsrGraph & graph ) const override {
+        vector<int> bfsList = directionOptimizingBFS( graph, inGraph, startNode );
+        return permutationFromOrder( bfsList, graph.numOfNodes );
+    } // compute
+
+private:
+    int startNode;
+    const CsrGraph * inGraph;
+};
+
+// 依 DFS 拜訪順序編號，沒拜訪到的節點接在後面
+class DFSOrder : public Ordering {
+public:
+    explicit DFSOrder( int startNode = 0 ) : startNode( startNode ) {}
+
+    string name() const override { return "dfsOrder"; }
+
+    Permutation compute( const CsrGraph & graph ) const override {
+        vector<int> dfsList = dfs( graph, startNode );
+        return permutationFromOrder( dfsList, graph.numOfNodes );
+    } // compute
+
+private:
+    int startNode;
+};
+
+// 多起點模式選擇起點的方式
+enum SeedPolicy {
+    LOWEST_ID_SEED,             // 元件依最小 ID 排列，元件內從 ID 小的節點開始
+    HIGHEST_DEGREE_SEED,        // 元件依最大 out-degree 排列，元件內從 degree 大的節點開始
+    LARGEST_COMPONENT_SEED      // 節點多的元件先，元件內從 ID 小的節點開始
+};
+
+// 走完所有弱連通元件的 BFS / DFS 編號：
+// 每個元件先依 policy 排好順序並分到連續的新 ID 區段，元件之間互不相干，並行走訪；
+// 元件內依候選順序挑還沒拜訪的節點當起點，直到整個元件都走過，總共 O(V + E)。
+// parallelSubtrees 為 true 時（只用於 DFS）改以 parallelDFS 走訪，大元件內的子樹也能分給多個執行緒，
+// 每棵分出去的子樹仍佔連續的新 ID，但結果與排程有關
+class ComponentTraversalOrder : public Ordering {
+public:
+    ComponentTraversalOrder( bool depthFirst, SeedPolicy policy, bool parallelSubtrees = false )
+        : depthFirst( depthFirst ), policy( policy ), parallelSubtrees( depthFirst && parallelSubtrees ) {}
+
+    string name() const override {
+        string suffix = policy == HIGHEST_DEGREE_SEED ? "Degree" : policy == LARGEST_COMPONENT_SEED ? "Size" : "";
+        return string( depthFirst ? "dfsOrder" : "bfsOrder" ) + "All" + suffix + ( parallelSubtrees ? "Parallel" : "" );
+    } // name
+
+    Permutation compute( const CsrGraph & graph ) const override {
+        int numOfNodes = graph.numOfNodes;
+        vector<int> label = weaklyConnectedComponents( graph );
+
+        // 元件編號依最小 ID 排列，順便統計大小與 degree 最大的節點
+        vector<int> index( numOfNodes );
+        vector<int> componentSize;
+        vector<int> hub;
+        for ( int v = 0; v < numOfNodes; v++ ) {
+            if ( label[v] == v ) {
+                index[v] = componentSize.size();
+                componentSize.push_back( 0 );
+                hub.push_back( v );
+            } // if
+
+            int c = index[label[v]];
+            componentSize[c]++;
+            if ( graph.degree( v ) > graph.degree( hub[c] ) )
+                hub[c] = v;
+        } // for
+
+        int numComponents = componentSize.size();
+        vector<int> components( numComponents );
+        for ( int c = 0; c < numComponents; c++ )
+            components[c] = c;
+
+        // 由大到小的穩定排序：key 取「最大值 - 值」後以計數排序，同值時維持最小 ID 的順序
+        auto sortDescending = [&]( const vector<int> & value ) {
+            int maximum = maxDegree( value );
+            vector<int> key( value.size() );
+            for ( size_t i = 0; i < value.size(); i++ )
+                key[i] = maximum - value[i];
+            return sortByKey( key, maximum + 1 );
+        };
+
+        if ( policy == HIGHEST_DEGREE_SEED ) {
+            vector<int> hubDegree( numComponents );
+            for ( int c = 0; c < numComponents; c++ )
+                hubDegree[c] = graph.degree( hub[c] );
+            components = sortDescending( hubDegree );
+        } // if
+        else if ( policy == LARGEST_COMPONENT_SEED )
+            components = sortDescending( componentSize );
+
+        // 每個元件在新順序中的區段
+        vector<int> rank( numComponents );
+        vector<int> componentStart( numComponents + 1, 0 );
+        for ( int r = 0; r < numComponents; r++ ) {
+            rank[components[r]] = r;
+            componentStart[r + 1] = componentStart[r] + componentSize[components[r]];
+        } // for
+
+        // 起點候選：各元件的節點依 ID 由小到大；HIGHEST_DEGREE_SEED 時先依 degree 由大到小排好再分到各元件，
+        // 分配是穩定的，元件內即為 degree 由大到小、同 degree 依 ID
+        vector<int> seedOrder;
+        if ( policy == HIGHEST_DEGREE_SEED )
+            seedOrder = sortDescending( countDegree( graph, OUT_DEGREE ) );
+        vector<int> candidates( numOfNodes );
+        vector<int> cursor( componentStart.begin(), componentStart.end() - 1 );
+        for ( int i = 0; i < numOfNodes; i++ ) {
+            int v = seedOrder.empty() ? i : seedOrder[i];
+            candidates[cursor[rank[index[label[v]]]]++] = v;
+        } // for
+
+        // DFS 不會離開元件，依序走完所有候選時每個元件自然落在自己的區段
+        if ( parallelSubtrees )
+            return permutationFromOrder( parallelDFS( graph, candidates, componentStart ), numOfNodes );
+
+        vector<int> order( numOfNodes );
+        vector<char> visited( numOfNodes, 0 );
+        parallelForDynamic( 0, numComponents, 16, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t r = lo; r < hi; r++ ) {
+                int * first = candidates.data() + componentStart[r];
+                int * last = candidates.data() + componentStart[r + 1];
+                int next = componentStart[r];
+                for ( int * seed = first; seed != last; seed++ ) {
+                    if ( visited[*seed] )
+                        continue;
+                    if ( depthFirst )
+                        next += dfsFrom( graph, *seed, visited, order.data() + next );
+                    else
+                        next += bfsFrom( graph, *seed, visited, order.data() + next );
+                } // for
+            } // for
+        } );
+
+        return permutationFromOrder( order, numOfNodes );
+    } // compute
+
+private:
+    bool depthFirst;
+    SeedPolicy policy;
+    bool parallelSubtrees;
+};
+
+#endif // ORDER_H
@@ -0,0 +1,55 @@
+#ifndef ORDERINGS_H
+#define ORDERINGS_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gorder.h"
+#include "order.h"
+#include "partition.h"
+#include "rabbitOrder.h"
+#include "rcm.h"
+
+using namespace std;
+
+// 所有 reordering 的名稱（預設參數），與 name() 相同
+inline vector<string> orderingNames() {
+    return { "Original", "Random", "DegreeSort", "HubSort", "HubCluster", "DBG", "RCM",
+             "Gorder", "RabbitOrder", "bfsOrderAll", "dfsOrderAll", "dfsOrderAllParallel", "LDG", "Fennel" };
+} // orderingNames
+
+// 依名稱建立 reordering，名稱不認得時回傳 nullptr
+inline unique_ptr<Ordering> makeOrdering( const string & name ) {
+    if ( name == "Original" )
+        return unique_ptr<Ordering>( new OriginalOrder() );
+    if ( name == "Random" )
+        return unique_ptr<Ordering>( new RandomOrder() );
+    if ( name == "DegreeSort" )
+        return unique_ptr<Ordering>( new DegreeSort() );
+    if ( name == "HubSort" )
+        return unique_ptr<Ordering>( new HubSort() );
+    if ( name == "HubCluster" )
+        return unique_ptr<Ordering>( new HubCluster() );
+    if ( name == "DBG" )
+        return unique_ptr<Ordering>( new DBG() );
+    if ( name == "RCM" )
+        return unique_ptr<Ordering>( new RCMOrder() );
+    if ( name == "Gorder" )
+        return unique_ptr<Ordering>( new GOrder() );
+    if ( name == "RabbitOrder" )
+        return unique_ptr<Ordering>( new RabbitOrder() );
+    if ( name == "bfsOrderAll" )
+        return unique_ptr<Ordering>( new ComponentTraversalOrder( false, LOWEST_ID_SEED ) );
+    if ( name == "dfsOrderAll" )
+        return unique_ptr<Ordering>( new ComponentTraversalOrder( true, LOWEST_ID_SEED ) );
+    if ( name == "dfsOrderAllParallel" )
+        return unique_ptr<Ordering>( new ComponentTraversalOrder( true, LOWEST_ID_SEED, true ) );
+    // 串流分割：預設 DEFAULT_NUM_PARTS 個 part，part 內以 BFS 編號
+    if ( name == "LDG" || name == "Fennel" )
+        return unique_ptr<Ordering>( new PartitionOrder( name == "LDG" ? LDG_PARTITION : FENNEL_PARTITION, DEFAULT_NUM_PARTS,
+                                                         DEFAULT_PARTITION_SLACK, makeOrdering( "bfsOrderAll" ) ) );
+    return nullptr;
+} // makeOrdering
+
+#endif // ORDERINGS_H
@@ -0,0 +1,377 @@
+#ifndef OUT_OF_CORE_H
+#define OUT_OF_CORE_H
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "graph.h"
+#include "graphIO.h"
+#include "order.h"
+#include "parallel.h"
+
+using namespace std;
+
+// ---------------------------------------- 外部記憶體 reordering（圖比記憶體大時使用）
+// 1. 循序讀一次 edge list，只統計 in / out degree（O(V) 的陣列）
+// 2. 由 degree 陣列算出 permutation（degree 系列的 reordering）
+// 3. 再讀一次，每次最多 memoryBytes / 8 條邊：換成新 ID、排序後寫成一個 run 檔
+// 4. 把所有 run 做 k-way merge，輸出依 ( src, dst ) 排序的 edge list 或二進位 CSR；
+//    run 比一次能合併的數量（fan-in）多時，先分組合併成較長的 run，再進行下一輪
+// memoryBytes 限制的是邊的緩衝區（讀檔、run、合併與輸出的緩衝；run 以原地的 radix sort 排序），
+// 節點陣列（degree、permutation、offsets）另計
+
+// 邊壓成 64 位元：src 在高位，排序後即依 ( src, dst ) 排列
+inline uint64_t packEdge( int src, int dst ) {
+    return ( (uint64_t)(uint32_t)src << 32 ) | (uint32_t)dst;
+} // packEdge
+
+// 以 bufferBytes 大小的緩衝區循序讀 edge list（不 mmap、不整個載入），每條邊呼叫 func( src, dst )
+template <class Func>
+void streamEdgeList( const string & fileName, size_t bufferBytes, Func func ) {
+    ifstream input( fileName, ios::binary );
+    if ( !input ) {
+        cerr << "Error: Unable to open file." << endl;
+        exit(1);
+    } // if
+
+    vector<char> buffer( max<size_t>( bufferBytes, 1 << 16 ) );
+    size_t filled = 0;
+    bool eof = false;
+    while ( !eof || filled > 0 ) {
+        if ( !eof ) {
+            input.read( buffer.data() + filled, buffer.size() - filled );
+            filled += input.gcount();
+            if ( !input )
+                eof = true;
+        } // if
+
+        const char * begin = buffer.data();
+        const char * end = begin + filled;
+
+        // 只處理完整的行，到檔尾時才處理最後沒有換行的那一行
+        const char * limit = end;
+        if ( !eof ) {
+            while ( limit > begin && *( limit - 1 ) != '\n' )
+                limit--;
+            if ( limit == begin ) {
+                // 一行比緩衝區還長
+                buffer.resize( buffer.size() * 2 );
+                continue;
+            } // if
+        } // if
+
+        for ( const char * p = begin; p < limit; p = nextLine( p, limit ) ) {
+            if ( !isEdgeLine( p, limit ) )
+                continue;
+
+            unsigned long long node1 = 0, node2 = 0;
+            const char * q = p;
+            if ( !scanUnsigned( q, limit, node1 ) || !scanUnsigned( q, limit, node2 ) ) {
+                cerr << "Error: file illegal, each edge line needs two node IDs." << endl;
+                exit(1);
+            } // if
+
+            if ( node1 > INT_MAX || node2 > INT_MAX ) {
+                cerr << "Error: node ID exceeds the int range." << endl;
+                exit(1);
+            } // if
+
+            func( static_cast<int>( node1 ), static_cast<int>( node2 ) );
+        } // for
+
+        filled = end - limit;
+        memmove( buffer.data(), limit, filled );
+        if ( eof )
+            break;
+    } // while
+} // streamEdgeList
+
+// 讀 run 檔的緩衝讀取器
+class RunReader {
+public:
+    RunReader( const string & fileName, size_t bufferSize )
+        : input( fileName, ios::binary ), buffer( max<size_t>( bufferSize, 1 ) ), pos( 0 ), count( 0 ) {
+        if ( !input ) {
+            cerr << "Error: Unable to open run file." << endl;
+            exit(1);
+        } // if
+    } // RunReader
+
+    // 讀下一條邊，run 讀完時回傳 false
+    bool next( uint64_t & key ) {
+        if ( pos == count ) {
+            input.read( reinterpret_cast<char *>( buffer.data() ), buffer.size() * sizeof( uint64_t ) );
+            count = input.gcount() / sizeof( uint64_t );
+            pos = 0;
+            if ( count == 0 )
+                return false;
+        } // if
+
+        key = buffer[pos++];
+        return true;
+    } // next
+
+private:
+    ifstream input;
+    vector<uint64_t> buffer;
+    size_t pos;
+    size_t count;
+};
+
+// 合併時每個 run 的緩衝至少這麼多個 key
+const size_t MIN_RUN_BUFFER_KEYS = 1024;
+
+// 同時最多開幾個 run 檔：受 file descriptor 上限限制，保留一些給輸出檔與其他用途
+inline size_t maxOpenRuns() {
+    struct rlimit limit;
+    if ( getrlimit( RLIMIT_NOFILE, &limit ) != 0 || limit.rlim_cur == RLIM_INFINITY )
+        return 1024;
+    return limit.rlim_cur > 34 ? limit.rlim_cur - 32 : 2;
+} // maxOpenRuns
+
+// 把 runs 做 k-way merge，依 key 由小到大對每個 key 呼叫 func，每個 run 的緩衝為 bufferKeys 個 key；
+// 合併完刪除 run 檔
+template <class Func>
+void mergeRuns( const vector<string> & runs, size_t bufferKeys, Func func ) {
+    vector<unique_ptr<RunReader>> readers;
+    for ( const string & runName : runs )
+        readers.emplace_back( new RunReader( runName, bufferKeys ) );
+
+    typedef pair<uint64_t, int> Head;
+    priority_queue<Head, vector<Head>, greater<Head>> heap;
+    for ( size_t r = 0; r < readers.size(); r++ ) {
+        uint64_t key;
+        if ( readers[r]->next( key ) )
+            heap.push( { key, (int)r } );
+    } // for
+
+    while ( !heap.empty() ) {
+        Head head = heap.top();
+        heap.pop();
+        func( head.first );
+
+        uint64_t key;
+        if ( readers[head.second]->next( key ) )
+            heap.push( { key, head.second } );
+    } // while
+
+    readers.clear();
+    for ( const string & runName : runs )
+        remove( runName.c_str() );
+} // mergeRuns
+
+// 外部記憶體 reordering：讀 fileName，依 ordering 重新編號，
+// binaryCSR 為 true 時寫成含 permutation 的二進位 CSR，否則寫成 "src dst" 的 edge list；
+// 使用的 permutation 另外寫到 permutationName（permutation 檔）
+inline void outOfCoreReorder( const string & fileName, const DegreeOrdering & ordering, size_t memoryBytes,
+                              const string & outputName, bool binaryCSR, const string & permutationName ) {
+    // 記憶體預算的分配：
+    //   排序階段：讀檔緩衝 1/8，其餘給 run（每條邊 8 bytes，原地排序不需暫存）
+    //   合併階段：輸出緩衝 1/4，其餘平分給同時合併的 run，每個至少 MIN_RUN_BUFFER_KEYS 個 key
+    size_t streamBytes = memoryBytes / 8;
+    size_t chunkEdges = max<size_t>( ( memoryBytes - streamBytes ) / sizeof( uint64_t ), 1024 );
+    size_t outputBytes = max<size_t>( memoryBytes / 4, 1 << 16 );
+    size_t readerBytes = memoryBytes - memoryBytes / 4;
+    size_t fanIn = max<size_t>( 2, min( maxOpenRuns(), readerBytes / ( MIN_RUN_BUFFER_KEYS * sizeof( uint64_t ) ) ) );
+
+    // 第一輪：degree（只有節點陣列，讀檔緩衝可用整個預算）
+    vector<int> outDegree, inDegree;
+    uint64_t numEdges = 0;
+    streamEdgeList( fileName, memoryBytes, [&]( int src, int dst ) {
+        size_t needed = max( src, dst ) + 1;
+        if ( needed > outDegree.size() ) {
+            size_t size = max( needed, outDegree.size() * 2 );
+            outDegree.resize( size, 0 );
+            inDegree.resize( size, 0 );
+        } // if
+
+        outDegree[src]++;
+        inDegree[dst]++;
+        numEdges++;
+    } );
+
+    int numNodes = 0;
+    for ( int v = (int)outDegree.size() - 1; v >= 0; v-- ) {
+        if ( outDegree[v] > 0 || inDegree[v] > 0 ) {
+            numNodes = v + 1;
+            break;
+        } // if
+    } // for
+    outDegree.resize( numNodes );
+    inDegree.resize( numNodes );
+
+    vector<int> degree( numNodes );
+    DegreeType type = ordering.degreeType();
+    parallelFor( 0, numNodes, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t v = lo; v < hi; v++ )
+            degree[v] = ( type != OUT_DEGREE ? inDegree[v] : 0 ) + ( type != IN_DEGREE ? outDegree[v] : 0 );
+    } );
+    vector<int>().swap( inDegree );
+
+    Permutation permutation = ordering.computeFromDegrees( degree );
+    vector<int>().swap( degree );
+    writePermutationFile( permutationName, permutation );
+    const int * newID = permutation.newID.data();
+
+    // 第二輪：換 ID、排序、寫成 run 檔
+    vector<string> runs;
+    int numRunFiles = 0;
+    auto openRun = [&]( string & runName ) {
+        runName = outputName + ".run" + to_string( numRunFiles++ );
+        ofstream run( runName, ios::binary );
+        if ( !run ) {
+            cerr << "Error: Unable to open run file." << endl;
+            exit(1);
+        } // if
+        return run;
+    };
+    auto writeKeys = [&]( ofstream & run, const vector<uint64_t> & keys ) {
+        run.write( reinterpret_cast<const char *>( keys.data() ), keys.size() * sizeof( uint64_t ) );
+        if ( !run ) {
+            cerr << "Error: Unable to write run file." << endl;
+            exit(1);
+        } // if
+    };
+
+    // key 的高 32 位是 src，只需排到最大 ID 的位數
+    int keyBits = 33;
+    while ( numNodes > 1 && ( numNodes - 1 ) >> ( keyBits - 32 ) )
+        keyBits++;
+
+    vector<uint64_t> chunk;
+    chunk.reserve( chunkEdges );
+    auto flush = [&]() {
+        if ( chunk.empty() )
+            return;
+
+        parallelFlagSort( chunk.data(), chunk.size(), keyBits, []( uint64_t key ) { return key; } );
+        string runName;
+        ofstream run = openRun( runName );
+        writeKeys( run, chunk );
+        runs.push_back( runName );
+        chunk.clear();
+    };
+
+    streamEdgeList( fileName, streamBytes, [&]( int src, int dst ) {
+        chunk.push_back( packEdge( newID[src], newID[dst] ) );
+        if ( chunk.size() == chunkEdges )
+            flush();
+    } );
+    flush();
+    vector<uint64_t>().swap( chunk );
+
+    // run 比 fanIn 多時，每 fanIn 個合併成一個較長的 run，直到一輪合併得完
+    size_t outputKeys = outputBytes / sizeof( uint64_t );
+    while ( runs.size() > fanIn ) {
+        vector<string> merged;
+        for ( size_t first = 0; first < runs.size(); first += fanIn ) {
+            vector<string> group( runs.begin() + first, runs.begin() + min( first + fanIn, runs.size() ) );
+            if ( group.size() == 1 ) {
+                merged.push_back( group[0] );
+                continue;
+            } // if
+
+            string runName;
+            ofstream run = openRun( runName );
+            vector<uint64_t> keys;
+            keys.reserve( outputKeys );
+            mergeRuns( group, readerBytes / group.size() / sizeof( uint64_t ), [&]( uint64_t key ) {
+                keys.push_back( key );
+                if ( keys.size() == outputKeys ) {
+                    writeKeys( run, keys );
+                    keys.clear();
+                } // if
+            } );
+            writeKeys( run, keys );
+            merged.push_back( runName );
+        } // for
+
+        runs.swap( merged );
+    } // while
+
+    // k-way merge
+    ofstream outputFile( outputName, ios::binary );
+    if ( !outputFile ) {
+        cerr << "Error: Unable to open output file." << endl;
+        exit(1);
+    } // if
+
+    const char padding[64] = { 0 };
+    // 邊數超過 int 範圍時 offsets 寫成 64 位元（CsrGraph64 的格式）
+    bool wide = needsWideOffsets( numEdges );
+    CSRFileHeader header = makeCSRFileHeader( numNodes, numEdges, true, wide ? sizeof( int64_t ) : sizeof( int ) );
+    if ( binaryCSR ) {
+        // offsets 由新編號下的 out-degree 前綴和得到，可以先寫
+        vector<int64_t> offsets( numNodes + 1, 0 );
+        for ( int v = 0; v < numNodes; v++ )
+            offsets[newID[v] + 1] = outDegree[v];
+        for ( int v = 1; v <= numNodes; v++ )
+            offsets[v] += offsets[v - 1];
+
+        outputFile.write( reinterpret_cast<const char *>( &header ), sizeof( header ) );
+        outputFile.write( padding, header.offsetsPos - sizeof( header ) );
+        if ( wide )
+            outputFile.write( reinterpret_cast<const char *>( offsets.data() ), offsets.size() * sizeof( int64_t ) );
+        else {
+            vector<int> narrow( offsets.begin(), offsets.end() );
+            outputFile.write( reinterpret_cast<const char *>( narrow.data() ), narrow.size() * sizeof( int ) );
+        } // else
+        outputFile.write( padding, header.edgesPos - header.offsetsPos - offsets.size() * header.offsetWidth );
+    } // if
+    vector<int>().swap( outDegree );
+
+    vector<int> edgeBuffer;
+    size_t edgeBufferSize = outputBytes / sizeof( int );
+    vector<char> textBuffer( binaryCSR ? 0 : outputBytes + 2 * MAX_DIGITS + 2 );
+    char * text = textBuffer.data();
+    mergeRuns( runs, readerBytes / max<size_t>( runs.size(), 1 ) / sizeof( uint64_t ), [&]( uint64_t key ) {
+        int src = key >> 32;
+        int dst = (uint32_t)key;
+        if ( binaryCSR ) {
+            edgeBuffer.push_back( dst );
+            if ( edgeBuffer.size() == edgeBufferSize ) {
+                outputFile.write( reinterpret_cast<const char *>( edgeBuffer.data() ), edgeBuffer.size() * sizeof( int ) );
+                edgeBuffer.clear();
+            } // if
+        } // if
+        else {
+            text = appendDecimal( text, src );
+            *text++ = ' ';
+            text = appendDecimal( text, dst );
+            *text++ = '\n';
+            if ( text - textBuffer.data() >= (ptrdiff_t)outputBytes ) {
+                outputFile.write( textBuffer.data(), text - textBuffer.data() );
+                text = textBuffer.data();
+            } // if
+        } // else
+    } );
+
+    if ( binaryCSR ) {
+        outputFile.write( reinterpret_cast<const char *>( edgeBuffer.data() ), edgeBuffer.size() * sizeof( int ) );
+        outputFile.write( padding, header.permutationPos - header.edgesPos - numEdges * sizeof( int ) );
+        outputFile.write( reinterpret_cast<const char *>( newID ), numNodes * sizeof( int ) );
+    } // if
+    else
+        outputFile.write( textBuffer.data(), text - textBuffer.data() );
+
+    if ( !outputFile ) {
+        cerr << "Error: Unable to write output file." << endl;
+        exit(1);
+    } // if
+
+    outputFile.close();
+} // outOfCoreReorder
+
+#endif // OUT_OF_CORE_H
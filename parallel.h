@@ -0,0 +1,363 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// 目前執行緒的執行緒數量上限，0 表示不限制（由 ThreadLimit 設定）
+inline int & threadLimit() {
+    thread_local int limit = 0;
+    return limit;
+} // threadLimit
+
+// 執行緒數量，預設為硬體核心數，可用環境變數 REORDER_THREADS 指定；
+// 只在第一次呼叫時讀取（static 區域變數的初始化是 thread-safe 的），在 ThreadLimit 的範圍內不超過其上限
+inline int numOfThreads() {
+    static const int num = []() {
+        int n = 0;
+        const char * env = getenv( "REORDER_THREADS" );
+        if ( env != nullptr )
+            n = atoi( env );
+        if ( n <= 0 )
+            n = thread::hardware_concurrency();
+        return max( n, 1 );
+    }();
+
+    int limit = threadLimit();
+    return limit > 0 ? min( limit, num ) : num;
+} // numOfThreads
+
+// 在這個物件存在的期間，目前的執行緒（以及它透過 startThread 開出的執行緒）最多使用 limit 個執行緒，
+// 例如同時執行多個 reordering 時平分核心
+class ThreadLimit {
+public:
+    explicit ThreadLimit( int limit ) : previous( threadLimit() ) {
+        threadLimit() = limit;
+    } // ThreadLimit
+
+    ~ThreadLimit() {
+        threadLimit() = previous;
+    } // ~ThreadLimit
+
+    ThreadLimit( const ThreadLimit & ) = delete;
+    ThreadLimit & operator=( const ThreadLimit & ) = delete;
+
+private:
+    int previous;
+}; // ThreadLimit
+
+// 開一個執行緒執行 func( args... )，沿用目前執行緒的 ThreadLimit，巢狀的並行迴圈看到的執行緒數量不變
+template <class Func, class... Args>
+thread startThread( Func func, Args... args ) {
+    int limit = threadLimit();
+    return thread( [=]() {
+        ThreadLimit scope( limit );
+        func( args... );
+    } );
+} // startThread
+
+// 把 [begin, end) 平均切成 numOfThreads() 段，每段交給一個執行緒
+// func( tid, lo, hi ) 處理 [lo, hi)，段與 tid 的對應是固定的
+template <class Func>
+void parallelFor( size_t begin, size_t end, Func func ) {
+    int numThreads = numOfThreads();
+    size_t total = end > begin ? end - begin : 0;
+    if ( numThreads == 1 || total < 2 ) {
+        func( 0, begin, end );
+        return;
+    } // if
+
+    vector<thread> threads;
+    for ( int t = 0; t < numThreads; t++ ) {
+        size_t lo = begin + total * t / numThreads;
+        size_t hi = begin + total * ( t + 1 ) / numThreads;
+        threads.push_back( startThread( func, t, lo, hi ) );
+    } // for
+
+    for ( auto & th : threads )
+        th.join();
+} // parallelFor
+
+// 動態分配：每個執行緒每次取 grain 個索引，適合工作量不平均的迴圈
+// func( tid, lo, hi ) 處理 [lo, hi)
+template <class Func>
+void parallelForDynamic( size_t begin, size_t end, size_t grain, Func func ) {
+    int numThreads = numOfThreads();
+    if ( grain == 0 )
+        grain = 1;
+    if ( numThreads == 1 || end <= begin + grain ) {
+        func( 0, begin, end );
+        return;
+    } // if
+
+    atomic<size_t> next( begin );
+    auto worker = [&]( int tid ) {
+        while ( true ) {
+            size_t lo = next.fetch_add( grain );
+            if ( lo >= end )
+                break;
+            func( tid, lo, min( lo + grain, end ) );
+        } // while
+    };
+
+    vector<thread> threads;
+    for ( int t = 0; t < numThreads; t++ )
+        threads.push_back( startThread( worker, t ) );
+
+    for ( auto & th : threads )
+        th.join();
+} // parallelForDynamic
+
+// 並行排序：每個執行緒先排一段，再兩兩合併
+template <class T, class Compare>
+void parallelSort( T * data, size_t n, Compare comp ) {
+    int numThreads = numOfThreads();
+    if ( numThreads == 1 || n < 65536 ) {
+        sort( data, data + n, comp );
+        return;
+    } // if
+
+    vector<size_t> bound( numThreads + 1 );
+    for ( int i = 0; i <= numThreads; i++ )
+        bound[i] = n * i / numThreads;
+
+    parallelFor( 0, numThreads, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t c = lo; c < hi; c++ )
+            sort( data + bound[c], data + bound[c + 1], comp );
+    } );
+
+    vector<T> buffer( n );
+    T * from = data;
+    T * to = buffer.data();
+    for ( size_t width = 1; width < (size_t)numThreads; width *= 2 ) {
+        size_t numMerges = ( numThreads + 2 * width - 1 ) / ( 2 * width );
+        parallelForDynamic( 0, numMerges, 1, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t m = lo; m < hi; m++ ) {
+                size_t first = m * 2 * width;
+                size_t mid = min<size_t>( first + width, numThreads );
+                size_t last = min<size_t>( first + 2 * width, numThreads );
+                merge( from + bound[first], from + bound[mid], from + bound[mid], from + bound[last],
+                       to + bound[first], comp );
+            } // for
+        } );
+        swap( from, to );
+    } // for
+
+    if ( from != data ) {
+        parallelFor( 0, n, [&]( int, size_t lo, size_t hi ) {
+            copy( from + lo, from + hi, data + lo );
+        } );
+    } // if
+} // parallelSort
+
+template <class T>
+void parallelSort( T * data, size_t n ) {
+    parallelSort( data, n, less<T>() );
+} // parallelSort
+
+// 穩定的並行 counting sort：依 key( x )（0 ~ numKeys - 1）分配 input，同 key 維持原本順序
+// 各執行緒統計自己那段的直方圖，依 ( key, 執行緒 ) 的順序前綴和後分配
+template <class T, class Key>
+vector<T> parallelCountingSort( const vector<T> & input, size_t numKeys, Key key ) {
+    int numThreads = numOfThreads();
+    vector<size_t> count( numThreads * numKeys, 0 );
+    parallelFor( 0, input.size(), [&]( int tid, size_t lo, size_t hi ) {
+        size_t * local = count.data() + tid * numKeys;
+        for ( size_t i = lo; i < hi; i++ )
+            local[key( input[i] )]++;
+    } );
+
+    size_t sum = 0;
+    for ( size_t k = 0; k < numKeys; k++ ) {
+        for ( int t = 0; t < numThreads; t++ ) {
+            size_t c = count[t * numKeys + k];
+            count[t * numKeys + k] = sum;
+            sum += c;
+        } // for
+    } // for
+
+    vector<T> output( input.size() );
+    parallelFor( 0, input.size(), [&]( int tid, size_t lo, size_t hi ) {
+        size_t * cursor = count.data() + tid * numKeys;
+        for ( size_t i = lo; i < hi; i++ )
+            output[cursor[key( input[i] )]++] = input[i];
+    } );
+
+    return output;
+} // parallelCountingSort
+
+// ---------------------------------------- 原地 MSD radix sort（American flag sort）
+// key( x ) 回傳 64 位元的 key，只排 [ 0, keyBits ) 位（更高的位都是 0）。從最高位開始每次處理 8 位元：
+// 數出每個 bucket 的大小後，以 cycle 交換把元素直接換到自己的 bucket，再遞迴排各 bucket 的較低位數。
+// 除了每層的計數之外不需要額外的陣列，記憶體只有資料本身
+
+const int FLAG_SORT_DIGIT_BITS = 8;
+const size_t FLAG_SORT_SMALL = 32;          // 元素數不超過這個值時改用 insertion sort
+const size_t FLAG_SORT_PARALLEL_MIN = 16;   // 並行交換時，每個執行緒每個 bucket 平均至少要有的元素數
+
+// 以 cycle 交換把 [ next[b], end[b] ) 的元素換到各自的 bucket，
+// 每段的長度必須等於這些範圍中該 bucket 的元素數
+template <class T, class Digit>
+void flagCyclePermute( T * first, size_t * next, const size_t * end, size_t numBuckets, Digit digit ) {
+    for ( size_t b = 0; b < numBuckets; b++ ) {
+        while ( next[b] < end[b] ) {
+            T x = first[next[b]];
+            for ( size_t d = digit( x ); d != b; d = digit( x ) )
+                swap( x, first[next[d]++] );
+            first[next[b]++] = x;
+        } // while
+    } // for
+} // flagCyclePermute
+
+// 排序 key 的 [ 0, highBit ) 位（更高的位在這段中都相同），循序
+template <class T, class Key>
+void flagSort( T * first, size_t n, int highBit, Key key ) {
+    if ( n <= FLAG_SORT_SMALL || highBit <= 0 ) {
+        for ( size_t i = 1; i < n; i++ ) {
+            T x = first[i];
+            uint64_t k = key( x );
+            size_t j = i;
+            for ( ; j > 0 && key( first[j - 1] ) > k; j-- )
+                first[j] = first[j - 1];
+            first[j] = x;
+        } // for
+        return;
+    } // if
+
+    int shift = max( 0, highBit - FLAG_SORT_DIGIT_BITS );
+    size_t numBuckets = (size_t)1 << ( highBit - shift );
+    auto digit = [&]( const T & x ) { return ( key( x ) >> shift ) & ( numBuckets - 1 ); };
+
+    size_t count[1 << FLAG_SORT_DIGIT_BITS] = { 0 };
+    for ( size_t i = 0; i < n; i++ )
+        count[digit( first[i] )]++;
+
+    size_t bucketStart[( 1 << FLAG_SORT_DIGIT_BITS ) + 1], next[1 << FLAG_SORT_DIGIT_BITS];
+    size_t sum = 0;
+    for ( size_t b = 0; b < numBuckets; b++ ) {
+        bucketStart[b] = next[b] = sum;
+        sum += count[b];
+    } // for
+    bucketStart[numBuckets] = sum;
+
+    flagCyclePermute( first, next, bucketStart + 1, numBuckets, digit );
+    for ( size_t b = 0; b < numBuckets; b++ )
+        flagSort( first + bucketStart[b], bucketStart[b + 1] - bucketStart[b], shift, key );
+} // flagSort
+
+// 並行的原地交換（PARADIS）：每個 bucket 還沒放好的範圍 [ head[b], tail[b] ) 平均切給各執行緒，
+// 各執行緒只在自己的那幾段之間做 cycle 交換，放不進去的元素移到段尾；
+// 接著各 bucket 並行把已屬於自己的元素集中到範圍前面，剩下的留給下一輪。
+// 剩下的元素很少或某一輪沒有進展時，剩下的部分以循序的 cycle 交換完成
+template <class T, class Digit>
+void parallelFlagPermute( T * first, const size_t * count, size_t numBuckets, Digit digit, size_t * bucketStart ) {
+    int numThreads = numOfThreads();
+    vector<size_t> head( numBuckets ), tail( numBuckets );
+    size_t sum = 0;
+    for ( size_t b = 0; b < numBuckets; b++ ) {
+        bucketStart[b] = head[b] = sum;
+        sum += count[b];
+        tail[b] = sum;
+    } // for
+    bucketStart[numBuckets] = sum;
+
+    size_t remaining = sum;
+    vector<size_t> sliceNext( numThreads * numBuckets ), sliceEnd( numThreads * numBuckets );
+    while ( numThreads > 1 && remaining > numThreads * numBuckets * FLAG_SORT_PARALLEL_MIN ) {
+        parallelFor( 0, numThreads, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t t = lo; t < hi; t++ ) {
+                size_t * next = sliceNext.data() + t * numBuckets;
+                size_t * end = sliceEnd.data() + t * numBuckets;
+                for ( size_t b = 0; b < numBuckets; b++ ) {
+                    size_t length = tail[b] - head[b];
+                    next[b] = head[b] + length * t / numThreads;
+                    end[b] = head[b] + length * ( t + 1 ) / numThreads;
+                } // for
+
+                for ( size_t b = 0; b < numBuckets; b++ ) {
+                    while ( next[b] < end[b] ) {
+                        T x = first[next[b]];
+                        size_t d = digit( x );
+                        for ( ; d != b && next[d] < end[d]; d = digit( x ) )
+                            swap( x, first[next[d]++] );
+                        if ( d == b ) {
+                            first[next[b]++] = x;
+                        } // if
+                        else {
+                            // 這個執行緒在 bucket d 的段已滿：x 移到段尾，留給下一輪
+                            first[next[b]] = first[--end[b]];
+                            first[end[b]] = x;
+                        } // else
+                    } // while
+                } // for
+            } // for
+        } );
+
+        atomic<size_t> left( 0 );
+        parallelForDynamic( 0, numBuckets, 1, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t b = lo; b < hi; b++ ) {
+                T * placed = partition( first + head[b], first + tail[b], [&]( const T & x ) { return digit( x ) == b; } );
+                head[b] = placed - first;
+                left += tail[b] - head[b];
+            } // for
+        } );
+
+        if ( left == remaining )
+            break;
+        remaining = left;
+    } // while
+
+    flagCyclePermute( first, head.data(), tail.data(), numBuckets, digit );
+} // parallelFlagPermute
+
+// 並行的原地 radix sort：第一層並行計數、並行交換，之後各 bucket 互不相干，由多個執行緒各自遞迴。
+// 所有元素的最高幾位都相同時先往下一層找，避免第一層只有一個 bucket
+template <class T, class Key>
+void parallelFlagSort( T * first, size_t n, int keyBits, Key key ) {
+    int numThreads = numOfThreads();
+    if ( numThreads == 1 || n < 65536 ) {
+        flagSort( first, n, keyBits, key );
+        return;
+    } // if
+
+    int highBit = keyBits;
+    while ( highBit > 0 ) {
+        int shift = max( 0, highBit - FLAG_SORT_DIGIT_BITS );
+        size_t numBuckets = (size_t)1 << ( highBit - shift );
+        auto digit = [&]( const T & x ) { return ( key( x ) >> shift ) & ( numBuckets - 1 ); };
+        vector<size_t> threadCount( numThreads * numBuckets, 0 );
+        parallelFor( 0, n, [&]( int tid, size_t lo, size_t hi ) {
+            size_t * local = threadCount.data() + tid * numBuckets;
+            for ( size_t i = lo; i < hi; i++ )
+                local[digit( first[i] )]++;
+        } );
+
+        vector<size_t> count( numBuckets, 0 ), bucketStart( numBuckets + 1 );
+        for ( int t = 0; t < numThreads; t++ ) {
+            for ( size_t b = 0; b < numBuckets; b++ )
+                count[b] += threadCount[t * numBuckets + b];
+        } // for
+
+        if ( count[digit( first[0] )] == n ) {
+            highBit = shift;
+            continue;
+        } // if
+
+        parallelFlagPermute( first, count.data(), numBuckets, digit, bucketStart.data() );
+        parallelForDynamic( 0, numBuckets, 1, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t b = lo; b < hi; b++ )
+                flagSort( first + bucketStart[b], bucketStart[b + 1] - bucketStart[b], shift, key );
+        } );
+        return;
+    } // while
+} // parallelFlagSort
+
+#endif // PARALLEL_H
@@ -0,0 +1,332 @@
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "graph.h"
+#include "order.h"
+#include "outOfCore.h"
+#include "parallel.h"
+
+using namespace std;
+
+// ---------------------------------------- 串流分割（LDG / Fennel）
+// 節點依 ID 順序串流一次，每個節點只看鄰居（出邊與入邊）中已經分好的那些落在哪些 part，
+// 立即決定自己的 part、之後不再改變：
+//   LDG   ：argmax |N(v) ∩ P_i| * ( 1 - |P_i| / C )
+//   Fennel：argmax |N(v) ∩ P_i| - alpha * gamma * |P_i|^( gamma - 1 )，gamma = 1.5，alpha = sqrt( k ) * m / n^1.5
+// C = ( 1 + slack ) * n / k 為每個 part 的容量上限，滿了的 part 不再考慮；同分時選較小的 part，再選編號小的。
+// 沒有鄰居落在其中的 part 分數只與大小有關，只需考慮最小的那個，每個節點 O( degree + log k )。
+// 分好後每個 part 佔一段連續的新 ID，part 內再以另一個 reordering 在 induced subgraph 上編號，
+// 切割邊少、part 內也有區域性，適合把圖依 ID 區段分給多台機器。
+// 圖放不進記憶體時，streamingPartitionEdgeList 直接串流依 src 分組的 edge list（例如 command 17 的輸出），
+// 只保留 O(V) 的陣列；檔案中只看得到出邊，因此節點只依已分好的出鄰居決定 part
+
+enum PartitionObjective {
+    LDG_PARTITION,
+    FENNEL_PARTITION
+};
+
+const double FENNEL_GAMMA = 1.5;
+const int DEFAULT_NUM_PARTS = 16;
+const double DEFAULT_PARTITION_SLACK = 0.1;
+
+const size_t STREAM_PARTITION_BUFFER_BYTES = 1 << 24;
+
+// 串流分割的狀態：每個 part 的大小與還沒滿的 part。
+// 每個節點先以 addNeighbor 記下已分好的鄰居所在的 part，再以 place 選出並放入它的 part
+class StreamingPartitioner {
+public:
+    StreamingPartitioner( int numNodes, uint64_t numEdges, int numParts, PartitionObjective objective, double slack )
+        : objective( objective ), partSize( numParts, 0 ), neighborCount( numParts, 0 ) {
+        capacity = max( 1.0, ceil( ( 1 + max( slack, 0.0 ) ) * numNodes / numParts ) );
+        alpha = numNodes > 0 ? sqrt( (double)numParts ) * numEdges / pow( (double)numNodes, 1.5 ) : 0;
+        for ( int p = 0; p < numParts; p++ )
+            open.insert( { 0, p } );
+    } // StreamingPartitioner
+
+    void addNeighbor( int p ) {
+        if ( p != -1 && neighborCount[p]++ == 0 )
+            touched.push_back( p );
+    } // addNeighbor
+
+    int place() {
+        int best = open.begin()->second;
+        double bestScore = score( 0, best );
+        for ( int p : touched ) {
+            if ( partSize[p] < capacity ) {
+                double s = score( neighborCount[p], p );
+                if ( s > bestScore || ( s == bestScore && make_pair( partSize[p], p ) < make_pair( partSize[best], best ) ) ) {
+                    best = p;
+                    bestScore = s;
+                } // if
+            } // if
+
+            neighborCount[p] = 0;
+        } // for
+
+        touched.clear();
+        open.erase( { partSize[best], best } );
+        if ( ++partSize[best] < capacity )
+            open.insert( { partSize[best], best } );
+        return best;
+    } // place
+
+private:
+    PartitionObjective objective;
+    double capacity;
+    double alpha;
+    vector<int> partSize;
+    set<pair<int, int>> open;       // 未滿的 part 依 ( 大小, 編號 ) 排列，開頭就是沒有鄰居時的最佳選擇
+    vector<int> neighborCount;
+    vector<int> touched;
+
+    double score( int count, int p ) const {
+        if ( objective == LDG_PARTITION )
+            return count * ( 1 - partSize[p] / capacity );
+        return count - alpha * FENNEL_GAMMA * pow( (double)partSize[p], FENNEL_GAMMA - 1 );
+    } // score
+};
+
+// 回傳每個節點所屬的 part（0 ~ numParts - 1）
+inline vector<int> streamingPartition( const CsrGraph & graph, int numParts, PartitionObjective objective, double slack ) {
+    int numNodes = graph.numOfNodes;
+    numParts = max( 1, numParts );
+    vector<int> part( numNodes, -1 );
+    if ( numNodes == 0 )
+        return part;
+
+    CsrGraph inGraph;
+    transposeCSR( graph, inGraph );
+
+    StreamingPartitioner partitioner( numNodes, graph.numOfEdges, numParts, objective, slack );
+    const CsrGraph * directions[2] = { &graph, &inGraph };
+    for ( int v = 0; v < numNodes; v++ ) {
+        for ( const CsrGraph * g : directions ) {
+            for ( int e = g->offsets[v]; e < g->offsets[v + 1]; e++ )
+                partitioner.addNeighbor( part[g->edges[e]] );
+        } // for
+
+        part[v] = partitioner.place();
+    } // for
+
+    return part;
+} // streamingPartition
+
+// 直接串流 edge list 檔分割，不建 CSR：第一輪只數節點數與邊數（容量與 Fennel 的 alpha 需要），
+// 第二輪依檔案順序每遇到一個新的 src 就以它的出鄰居決定 part；沒有出邊的節點最後依 ID 放入。
+// 檔案必須依 src 分組（同一個 src 的邊連在一起），否則回報錯誤
+inline vector<int> streamingPartitionEdgeList( const string & fileName, int numParts, PartitionObjective objective,
+                                               double slack, size_t bufferBytes = STREAM_PARTITION_BUFFER_BYTES ) {
+    int numNodes = 0;
+    uint64_t numEdges = 0;
+    streamEdgeList( fileName, bufferBytes, [&]( int src, int dst ) {
+        numNodes = max( numNodes, max( src, dst ) + 1 );
+        numEdges++;
+    } );
+
+    numParts = max( 1, numParts );
+    vector<int> part( numNodes, -1 );
+    StreamingPartitioner partitioner( numNodes, numEdges, numParts, objective, slack );
+    int current = -1;
+    streamEdgeList( fileName, bufferBytes, [&]( int src, int dst ) {
+        if ( src != current ) {
+            if ( current != -1 )
+                part[current] = partitioner.place();
+            if ( part[src] != -1 ) {
+                cerr << "Error: edge list must be grouped by source for streaming partition." << endl;
+                exit(1);
+            } // if
+
+            current = src;
+        } // if
+
+        partitioner.addNeighbor( part[dst] );
+    } );
+
+    if ( current != -1 )
+        part[current] = partitioner.place();
+    for ( int v = 0; v < numNodes; v++ ) {
+        if ( part[v] == -1 )
+            part[v] = partitioner.place();
+    } // for
+
+    return part;
+} // streamingPartitionEdgeList
+
+// 每個 part 佔一段連續的新 ID（依 part 編號排列）；part 內以 inner 在 induced subgraph 上編號，
+// inner 為 nullptr 時 part 內維持原本的 ID 順序
+inline Permutation partitionContiguousOrder( const CsrGraph & graph, const vector<int> & part, int numParts,
+                                             const Ordering * inner ) {
+    int numNodes = graph.numOfNodes;
+    vector<int> nodes( numNodes );
+    for ( int v = 0; v < numNodes; v++ )
+        nodes[v] = v;
+    vector<int> members = parallelCountingSort( nodes, numParts, [&]( int v ) { return part[v]; } );
+
+    vector<int> partStart( numParts + 1, 0 );
+    for ( int v = 0; v < numNodes; v++ )
+        partStart[part[v] + 1]++;
+    for ( int p = 0; p < numParts; p++ )
+        partStart[p + 1] += partStart[p];
+
+    // localID[ v ]：v 在自己 part 中依 ID 的位置
+    vector<int> localID( numNodes );
+    parallelFor( 0, numNodes, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t i = lo; i < hi; i++ )
+            localID[members[i]] = i - partStart[part[members[i]]];
+    } );
+
+    Permutation permutation;
+    permutation.newID.resize( numNodes );
+    for ( int p = 0; p < numParts; p++ ) {
+        const int * first = members.data() + partStart[p];
+        int size = partStart[p + 1] - partStart[p];
+        if ( inner == nullptr || size == 0 ) {
+            for ( int i = 0; i < size; i++ )
+                permutation.newID[first[i]] = partStart[p] + i;
+            continue;
+        } // if
+
+        // part 內部的邊，兩端換成 localID
+        vector<int> csrOffsetArray( size + 1, 0 );
+        parallelFor( 0, size, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t i = lo; i < hi; i++ ) {
+                int u = first[i];
+                for ( int e = graph.offsets[u]; e < graph.offsets[u + 1]; e++ )
+                    csrOffsetArray[i + 1] += part[graph.edges[e]] == p;
+            } // for
+        } );
+
+        for ( int i = 0; i < size; i++ )
+            csrOffsetArray[i + 1] += csrOffsetArray[i];
+
+        vector<int> csrEdgeArray( csrOffsetArray[size] );
+        parallelFor( 0, size, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t i = lo; i < hi; i++ ) {
+                int u = first[i];
+                int * out = csrEdgeArray.data() + csrOffsetArray[i];
+                for ( int e = graph.offsets[u]; e < graph.offsets[u + 1]; e++ ) {
+                    if ( part[graph.edges[e]] == p )
+                        *out++ = localID[graph.edges[e]];
+                } // for
+            } // for
+        } );
+
+        CsrGraph subgraph;
+        subgraph.adopt( csrOffsetArray, csrEdgeArray );
+        Permutation local = inner->compute( subgraph );
+        parallelFor( 0, size, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t i = lo; i < hi; i++ )
+                permutation.newID[first[i]] = partStart[p] + local.newID[i];
+        } );
+    } // for
+
+    return permutation;
+} // partitionContiguousOrder
+
+// 不需要圖的版本：每個 part 佔一段連續的新 ID，part 內維持原本的 ID 順序
+inline Permutation partitionContiguousOrder( const vector<int> & part, int numParts ) {
+    vector<int> next( max( 1, numParts ) + 1, 0 );
+    for ( int p : part )
+        next[p + 1]++;
+    for ( size_t p = 1; p < next.size(); p++ )
+        next[p] += next[p - 1];
+
+    Permutation permutation;
+    permutation.newID.resize( part.size() );
+    for ( size_t v = 0; v < part.size(); v++ )
+        permutation.newID[v] = next[part[v]]++;
+    return permutation;
+} // partitionContiguousOrder
+
+// 分割品質：切割邊數（兩端在不同 part 的邊）與平衡度（最大 part / 平均大小）
+struct PartitionStats {
+    uint64_t edgeCut = 0;
+    uint64_t numEdges = 0;
+    int minPartSize = 0;
+    int maxPartSize = 0;
+    double balance = 0;
+};
+
+// 由切割邊數與各節點的 part 算出統計
+inline PartitionStats makePartitionStats( uint64_t edgeCut, uint64_t numEdges, const vector<int> & part, int numParts ) {
+    vector<int> partSize( max( 1, numParts ), 0 );
+    for ( int p : part )
+        partSize[p]++;
+
+    PartitionStats stats;
+    stats.edgeCut = edgeCut;
+    stats.numEdges = numEdges;
+    stats.minPartSize = *min_element( partSize.begin(), partSize.end() );
+    stats.maxPartSize = *max_element( partSize.begin(), partSize.end() );
+    stats.balance = part.size() > 0 ? (double)stats.maxPartSize * partSize.size() / part.size() : 0;
+    return stats;
+} // makePartitionStats
+
+inline PartitionStats partitionStats( const CsrGraph & graph, const vector<int> & part, int numParts ) {
+    int numNodes = graph.numOfNodes;
+    vector<uint64_t> threadCut( numOfThreads(), 0 );
+    parallelFor( 0, numNodes, [&]( int tid, size_t lo, size_t hi ) {
+        uint64_t cut = 0;
+        for ( size_t u = lo; u < hi; u++ ) {
+            for ( int e = graph.offsets[u]; e < graph.offsets[u + 1]; e++ )
+                cut += part[graph.edges[e]] != part[u];
+        } // for
+        threadCut[tid] = cut;
+    } );
+
+    uint64_t edgeCut = 0;
+    for ( uint64_t cut : threadCut )
+        edgeCut += cut;
+    return makePartitionStats( edgeCut, graph.numOfEdges, part, numParts );
+} // partitionStats
+
+// 串流 edge list 檔計算分割品質
+inline PartitionStats partitionStatsEdgeList( const string & fileName, const vector<int> & part, int numParts,
+                                              size_t bufferBytes = STREAM_PARTITION_BUFFER_BYTES ) {
+    uint64_t edgeCut = 0, numEdges = 0;
+    streamEdgeList( fileName, bufferBytes, [&]( int src, int dst ) {
+        edgeCut += part[src] != part[dst];
+        numEdges++;
+    } );
+    return makePartitionStats( edgeCut, numEdges, part, numParts );
+} // partitionStatsEdgeList
+
+// 以串流分割產生 part 連續的編號；inner 為 part 內使用的 reordering（nullptr 表示維持原順序）
+class PartitionOrder : public Ordering {
+public:
+    PartitionOrder( PartitionObjective objective, int numParts, double slack, shared_ptr<const Ordering> inner = nullptr )
+        : objective( objective ), numParts( max( 1, numParts ) ), slack( slack ), inner( inner ) {}
+
+    string name() const override { return objective == FENNEL_PARTITION ? "Fennel" : "LDG"; }
+
+    vector<int> partition( const CsrGraph & graph ) const {
+        return streamingPartition( graph, numParts, objective, slack );
+    } // partition
+
+    Permutation order( const CsrGraph & graph, const vector<int> & part ) const {
+        return partitionContiguousOrder( graph, part, numParts, inner.get() );
+    } // order
+
+    Permutation compute( const CsrGraph & graph ) const override {
+        return order( graph, partition( graph ) );
+    } // compute
+
+    int parts() const { return numParts; }
+
+private:
+    PartitionObjective objective;
+    int numParts;
+    double slack;
+    shared_ptr<const Ordering> inner;
+};
+
+#endif // PARTITION_H
@@ -0,0 +1,285 @@
+#ifndef RABBIT_ORDER_H
+#define RABBIT_ORDER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "graph.h"
+#include "order.h"
+#include "parallel.h"
+
+using namespace std;
+
+// ---------------------------------------- Rabbit Order（Arai et al., IPDPS 2016）
+// 1. 社群聚合：把圖視為無向加權圖，依 degree 由小到大處理每個節點 u，
+//    先把 u 的邊依目前所屬社群合併，再找讓模組度增益
+//        ΔQ( u, v ) = 2 * ( w(u,v) / 2m - d(u) * d(v) / (2m)^2 )
+//    最大的鄰居社群 v；ΔQ > 0 就把 u 併入 v（u 成為 v 在 dendrogram 上的子節點），
+//    否則 u 成為最上層的社群。
+// 2. 編號：對每個最上層社群的 dendrogram 做 DFS，同一社群的節點得到連續的新 ID。
+// 並行版本：多個執行緒依序取節點處理，合併時以 try-lock 鎖住目標社群，
+// 目標正在被處理就先延後，最後再依序補做；因此多執行緒時結果會隨排程不同。
+
+struct RabbitEdge {
+    int dst;
+    int weight;
+};
+
+class RabbitOrder : public Ordering {
+public:
+    string name() const override { return "RabbitOrder"; }
+
+    Permutation compute( const CsrGraph & graph ) const override {
+        int numOfNodes = graph.numOfNodes;
+        Permutation permutation;
+        permutation.newID.resize( numOfNodes );
+        if ( numOfNodes == 0 )
+            return permutation;
+
+        State state( numOfNodes );
+        buildUndirectedEdges( graph, state );
+
+        // 依 degree 由小到大（同 degree 依 ID）決定處理順序
+        vector<uint64_t> keys( numOfNodes );
+        parallelFor( 0, numOfNodes, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t v = lo; v < hi; v++ )
+                keys[v] = ( (uint64_t)state.edges[v].size() << 32 ) | v;
+        } );
+        parallelSort( keys.data(), keys.size() );
+
+        // 社群聚合
+        vector<vector<int>> postponed( numOfThreads() );
+        parallelForDynamic( 0, numOfNodes, 64, [&]( int tid, size_t lo, size_t hi ) {
+            for ( size_t i = lo; i < hi; i++ ) {
+                int node = (uint32_t)keys[i];
+                if ( !process( state, node ) )
+                    postponed[tid].push_back( node );
+            } // for
+        } );
+
+        // 延後的節點依序補做，此時沒有其他執行緒，一定成功
+        for ( auto & list : postponed ) {
+            for ( int node : list )
+                process( state, node );
+        } // for
+
+        // 最上層社群依形成的順序排列
+        vector<int> tops;
+        for ( size_t i = 0; i < keys.size(); i++ ) {
+            int node = (uint32_t)keys[i];
+            if ( state.dest[node].load( memory_order_relaxed ) == -1 )
+                tops.push_back( node );
+        } // for
+
+        assignIDs( state, tops, permutation );
+        return permutation;
+    } // compute
+
+private:
+    struct State {
+        vector<vector<RabbitEdge>> edges;           // 尚未處理的社群才保留邊
+        unique_ptr<atomic<int>[]> dest;             // 併入的社群，-1 表示仍是社群的代表
+        unique_ptr<atomic<double>[]> strength;      // 社群的加權 degree
+        unique_ptr<atomic<char>[]> locked;
+        vector<char> processed;
+        vector<int> child;                          // dendrogram：第一個子節點
+        vector<int> sibling;                        // dendrogram：下一個兄弟
+        double totalWeight = 0;                     // 2m
+
+        explicit State( int numOfNodes )
+            : edges( numOfNodes ), dest( new atomic<int>[numOfNodes] ),
+              strength( new atomic<double>[numOfNodes] ), locked( new atomic<char>[numOfNodes] ),
+              processed( numOfNodes, 0 ), child( numOfNodes, -1 ), sibling( numOfNodes, -1 ) {}
+    };
+
+    static bool tryLock( State & state, int node ) {
+        return state.locked[node].exchange( 1, memory_order_acquire ) == 0;
+    } // tryLock
+
+    static void lock( State & state, int node ) {
+        while ( !tryLock( state, node ) ) {
+        } // while
+    } // lock
+
+    static void unlock( State & state, int node ) {
+        state.locked[node].store( 0, memory_order_release );
+    } // unlock
+
+    // 找出節點目前所屬社群的代表，順便壓縮路徑
+    static int findRoot( State & state, int node ) {
+        int root = node;
+        int next;
+        while ( ( next = state.dest[root].load( memory_order_acquire ) ) != -1 )
+            root = next;
+
+        while ( node != root ) {
+            next = state.dest[node].load( memory_order_relaxed );
+            state.dest[node].store( root, memory_order_relaxed );
+            node = next;
+        } // while
+
+        return root;
+    } // findRoot
+
+    // 把有向 CSR 轉成無向的邊，每條邊權重 1，兩端各記一次
+    static void buildUndirectedEdges( const CsrGraph & graph, State & state ) {
+        int numOfNodes = graph.numOfNodes;
+        unique_ptr<atomic<int>[]> count( new atomic<int>[numOfNodes] );
+        parallelFor( 0, numOfNodes, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t v = lo; v < hi; v++ ) {
+                count[v].store( graph.degree( v ), memory_order_relaxed );
+                state.dest[v].store( -1, memory_order_relaxed );
+                state.locked[v].store( 0, memory_order_relaxed );
+            } // for
+        } );
+
+        parallelFor( 0, graph.numOfEdges, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t e = lo; e < hi; e++ )
+                count[graph.edges[e]].fetch_add( 1, memory_order_relaxed );
+        } );
+
+        parallelFor( 0, numOfNodes, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t v = lo; v < hi; v++ ) {
+                int degree = count[v].load( memory_order_relaxed );
+                state.edges[v].resize( degree );
+                state.strength[v].store( degree, memory_order_relaxed );
+                count[v].store( graph.degree( v ), memory_order_relaxed );
+            } // for
+        } );
+
+        // 出邊放在前段，入邊由 count 記錄的位置往後填
+        parallelFor( 0, numOfNodes, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t u = lo; u < hi; u++ ) {
+                RabbitEdge * out = state.edges[u].data();
+                for ( int e = graph.offsets[u]; e < graph.offsets[u + 1]; e++ ) {
+                    int v = graph.edges[e];
+                    *out++ = { v, 1 };
+                    state.edges[v][count[v].fetch_add( 1, memory_order_relaxed )] = { (int)u, 1 };
+                } // for
+            } // for
+        } );
+
+        state.totalWeight = 2.0 * graph.numOfEdges;
+    } // buildUndirectedEdges
+
+    // 處理節點 u；目標社群被其他執行緒鎖住時回傳 false（稍後重做）
+    static bool process( State & state, int u ) {
+        lock( state, u );
+
+        // 把 u 的邊依所屬社群合併
+        vector<RabbitEdge> & edges = state.edges[u];
+        for ( RabbitEdge & edge : edges )
+            edge.dst = findRoot( state, edge.dst );
+
+        sort( edges.begin(), edges.end(), []( const RabbitEdge & a, const RabbitEdge & b ) {
+            return a.dst < b.dst;
+        } );
+
+        size_t size = 0;
+        for ( size_t i = 0; i < edges.size(); i++ ) {
+            if ( edges[i].dst == u )
+                continue;
+            if ( size > 0 && edges[size - 1].dst == edges[i].dst )
+                edges[size - 1].weight += edges[i].weight;
+            else
+                edges[size++] = edges[i];
+        } // for
+
+        edges.resize( size );
+
+        // 找模組度增益最大的鄰居社群
+        double strengthU = state.strength[u].load( memory_order_relaxed );
+        double bestGain = 0;
+        int best = -1;
+        for ( const RabbitEdge & edge : edges ) {
+            double strengthV = state.strength[edge.dst].load( memory_order_relaxed );
+            double gain = edge.weight / state.totalWeight -
+                          strengthU * strengthV / ( state.totalWeight * state.totalWeight );
+            if ( gain > bestGain ) {
+                bestGain = gain;
+                best = edge.dst;
+            } // if
+        } // for
+
+        if ( best == -1 ) {
+            // 沒有正增益，u 成為最上層社群，之後不再需要它的邊
+            state.processed[u] = 1;
+            vector<RabbitEdge>().swap( edges );
+            unlock( state, u );
+            return true;
+        } // if
+
+        // 目標正在被其他執行緒處理，或剛併入別的社群：稍後重做
+        if ( !tryLock( state, best ) ) {
+            unlock( state, u );
+            return false;
+        } // if
+
+        if ( state.dest[best].load( memory_order_acquire ) != -1 ) {
+            unlock( state, best );
+            unlock( state, u );
+            return false;
+        } // if
+
+        // 把 u 併入 best
+        state.strength[best].store( state.strength[best].load( memory_order_relaxed ) + strengthU,
+                                    memory_order_relaxed );
+        if ( !state.processed[best] )
+            state.edges[best].insert( state.edges[best].end(), edges.begin(), edges.end() );
+        vector<RabbitEdge>().swap( edges );
+        state.sibling[u] = state.child[best];
+        state.child[best] = u;
+        state.processed[u] = 1;
+        state.dest[u].store( best, memory_order_release );
+
+        unlock( state, best );
+        unlock( state, u );
+        return true;
+    } // process
+
+    // 對每個最上層社群的 dendrogram 做 DFS 編號，各社群並行處理
+    static void assignIDs( State & state, const vector<int> & tops, Permutation & permutation ) {
+        vector<int> communitySize( tops.size() + 1, 0 );
+        parallelForDynamic( 0, tops.size(), 64, [&]( int, size_t lo, size_t hi ) {
+            vector<int> stack;
+            for ( size_t t = lo; t < hi; t++ ) {
+                int count = 0;
+                stack.push_back( tops[t] );
+                while ( !stack.empty() ) {
+                    int node = stack.back();
+                    stack.pop_back();
+                    count++;
+                    for ( int c = state.child[node]; c != -1; c = state.sibling[c] )
+                        stack.push_back( c );
+                } // while
+
+                communitySize[t + 1] = count;
+            } // for
+        } );
+
+        for ( size_t t = 1; t <= tops.size(); t++ )
+            communitySize[t] += communitySize[t - 1];
+
+        // 子節點串列由新到舊，依序推入堆疊後最早併入的子節點會先被走訪
+        parallelForDynamic( 0, tops.size(), 64, [&]( int, size_t lo, size_t hi ) {
+            vector<int> stack;
+            for ( size_t t = lo; t < hi; t++ ) {
+                int next = communitySize[t];
+                stack.push_back( tops[t] );
+                while ( !stack.empty() ) {
+                    int node = stack.back();
+                    stack.pop_back();
+                    permutation.newID[node] = next++;
+                    for ( int c = state.child[node]; c != -1; c = state.sibling[c] )
+                        stack.push_back( c );
+                } // while
+            } // for
+        } );
+    } // assignIDs
+};
+
+#endif // RABBIT_ORDER_H
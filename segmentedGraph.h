@@ -0,0 +1,333 @@
+#ifndef SEGMENTED_GRAPH_H
+#define SEGMENTED_GRAPH_H
+
+#include <iostream>
+#include <cstdint>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "graph.h"
+#include "kernels.h"
+#include "parallel.h"
+
+using namespace std;
+
+// ---------------------------------------- 分段的 CSR（pull 方向的 cache blocking，Zhang et al., Cagra）
+// 來源節點依 ID 切成每段 segmentSize 個，每段的屬性陣列（例如 PageRank 的 contribution）剛好放進 LLC。
+// 每段一個 sub-CSR：只列出有入鄰居落在這段的目的節點（rowID 遞增），每列的來源都在這段內，
+// 一次只處理一段時，隨機讀取都落在 cache 裡。各段算出的部分結果（每列一個）最後再合併：
+// 目的節點同樣切成 segmentSize 大小的區塊，每個區塊依序掃過各段落在該區塊的列（mergeStart），
+// 區塊之間互不重疊，並行合併不需要 atomic。
+// reordering 把常用的節點集中到前面之後，前幾段幾乎涵蓋所有的列，效果更好
+
+const size_t DEFAULT_LLC_BYTES = 8 << 20;
+
+// LLC 大小，讀不到時使用 DEFAULT_LLC_BYTES
+inline size_t lastLevelCacheBytes() {
+    long bytes = -1;
+#if defined( _SC_LEVEL3_CACHE_SIZE )
+    bytes = sysconf( _SC_LEVEL3_CACHE_SIZE );
+#endif
+    return bytes > 0 ? bytes : DEFAULT_LLC_BYTES;
+} // lastLevelCacheBytes
+
+// 每段的來源節點數：屬性陣列佔一半的 LLC，另一半留給 CSR 的串流讀取與部分結果
+inline int segmentSizeFor( size_t llcBytes, size_t propertyBytes = sizeof( double ) ) {
+    return min<size_t>( INT_MAX, max<size_t>( 1024, llcBytes / 2 / propertyBytes ) );
+} // segmentSizeFor
+
+struct SegmentedGraph {
+    int numOfNodes = 0;
+    int numOfEdges = 0;
+    int segmentSize = 1;
+    int numSegments = 0;
+    vector<int> segmentRowStart;    // 長度 numSegments + 1，第 s 段的列為 [ segmentRowStart[s], segmentRowStart[s + 1] )
+    vector<int> rowID;              // 每列的目的節點
+    vector<int> rowOffset;          // 長度 列數 + 1，每列的邊在 edges 中的起點
+    vector<int> edges;              // 來源節點（原本的 ID）
+    vector<int> mergeStart;         // 第 s 段中第一個 rowID >= b * segmentSize 的列：mergeStart[ s * ( numBlocks() + 1 ) + b ]
+
+    int numRows() const {
+        return rowID.size();
+    } // numRows
+
+    int numBlocks() const {
+        return ( (int64_t)numOfNodes + segmentSize - 1 ) / segmentSize;
+    } // numBlocks
+
+    size_t bytes() const {
+        return ( segmentRowStart.size() + rowID.size() + rowOffset.size() + edges.size() + mergeStart.size() ) * sizeof( int );
+    } // bytes
+};
+
+// 由入邊的 CSR（inGraph 每列的來源由小到大）建立分段的 CSR：
+// 各執行緒處理連續的一段目的節點，統計每段的列數與邊數後依 ( 段, 執行緒 ) 的順序前綴和，
+// 第二輪依序填入，因此每段的列依目的節點遞增，結果與執行緒數量無關
+inline void segmentCSR( const CsrGraph & inGraph, int segmentSize, SegmentedGraph & segmented ) {
+    int numNodes = inGraph.numOfNodes;
+    int numThreads = numOfThreads();
+    segmentSize = max( 1, segmentSize );
+    int numSegments = max<int64_t>( 1, ( (int64_t)numNodes + segmentSize - 1 ) / segmentSize );
+
+    segmented.numOfNodes = numNodes;
+    segmented.numOfEdges = inGraph.numOfEdges;
+    segmented.segmentSize = segmentSize;
+    segmented.numSegments = numSegments;
+
+    // 第 v 列中來源落在各段的範圍（列已排序，依段切開即可）
+    auto forEachPiece = [&]( int v, auto func ) {
+        int e = inGraph.offsets[v], end = inGraph.offsets[v + 1];
+        while ( e < end ) {
+            int s = inGraph.edges[e] / segmentSize;
+            int last = min<int64_t>( end, lower_bound( inGraph.edges + e, inGraph.edges + end, (int64_t)( s + 1 ) * segmentSize ) - inGraph.edges );
+            func( s, e, last );
+            e = last;
+        } // while
+    };
+
+    // rowCount / edgeCount[ tid * numSegments + s ]，前綴和後變成寫入的起點
+    vector<int> rowCount( numThreads * numSegments, 0 ), edgeCount( numThreads * numSegments, 0 );
+    parallelFor( 0, numNodes, [&]( int tid, size_t lo, size_t hi ) {
+        int * rows = rowCount.data() + tid * numSegments;
+        int * count = edgeCount.data() + tid * numSegments;
+        for ( size_t v = lo; v < hi; v++ ) {
+            forEachPiece( v, [&]( int s, int first, int last ) {
+                rows[s]++;
+                count[s] += last - first;
+            } );
+        } // for
+    } );
+
+    segmented.segmentRowStart.assign( numSegments + 1, 0 );
+    int rowSum = 0, edgeSum = 0;
+    for ( int s = 0; s < numSegments; s++ ) {
+        segmented.segmentRowStart[s] = rowSum;
+        for ( int t = 0; t < numThreads; t++ ) {
+            int rows = rowCount[t * numSegments + s], count = edgeCount[t * numSegments + s];
+            rowCount[t * numSegments + s] = rowSum;
+            edgeCount[t * numSegments + s] = edgeSum;
+            rowSum += rows;
+            edgeSum += count;
+        } // for
+    } // for
+
+    segmented.segmentRowStart[numSegments] = rowSum;
+    segmented.rowID.resize( rowSum );
+    segmented.rowOffset.resize( rowSum + 1 );
+    segmented.rowOffset[rowSum] = edgeSum;
+    segmented.edges.resize( edgeSum );
+    parallelFor( 0, numNodes, [&]( int tid, size_t lo, size_t hi ) {
+        int * rowCursor = rowCount.data() + tid * numSegments;
+        int * edgeCursor = edgeCount.data() + tid * numSegments;
+        for ( size_t v = lo; v < hi; v++ ) {
+            forEachPiece( v, [&]( int s, int first, int last ) {
+                int row = rowCursor[s]++;
+                segmented.rowID[row] = v;
+                segmented.rowOffset[row] = edgeCursor[s];
+                copy( inGraph.edges + first, inGraph.edges + last, segmented.edges.begin() + edgeCursor[s] );
+                edgeCursor[s] += last - first;
+            } );
+        } // for
+    } );
+
+    int numBlocks = segmented.numBlocks();
+    segmented.mergeStart.resize( (size_t)numSegments * ( numBlocks + 1 ) );
+    parallelFor( 0, numSegments, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t s = lo; s < hi; s++ ) {
+            const int * first = segmented.rowID.data() + segmented.segmentRowStart[s];
+            const int * last = segmented.rowID.data() + segmented.segmentRowStart[s + 1];
+            for ( int b = 0; b <= numBlocks; b++ )
+                segmented.mergeStart[s * ( numBlocks + 1 ) + b] =
+                    lower_bound( first, last, (int64_t)b * segmentSize ) - segmented.rowID.data();
+        } // for
+    } );
+} // segmentCSR
+
+// 原圖的 out-degree：每個來源在 edges 中出現的次數（分段的 CSR 檔本身就足以跑 PageRank）
+inline vector<int> segmentedOutDegree( const SegmentedGraph & graph ) {
+    vector<int> outDegree( graph.numOfNodes, 0 );
+    parallelFor( 0, graph.numSegments, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t s = lo; s < hi; s++ ) {
+            int rowFirst = graph.segmentRowStart[s], rowLast = graph.segmentRowStart[s + 1];
+            for ( int e = graph.rowOffset[rowFirst]; e < graph.rowOffset[rowLast]; e++ )
+                outDegree[graph.edges[e]]++;
+        } // for
+    } );
+
+    return outDegree;
+} // segmentedOutDegree
+
+// 分段的 PageRank（pull）：結果與 pageRankPull 相同（浮點相加順序不同），outDegree 為原圖的 out-degree。
+// 每輪一段一段處理（段內並行），部分結果存到 partial，最後依目的節點區塊並行合併
+inline vector<double> segmentedPageRank( const SegmentedGraph & graph, const vector<int> & outDegree, int iterations ) {
+    int numNodes = graph.numOfNodes;
+    double base = ( 1.0 - PAGERANK_DAMPING ) / max( numNodes, 1 );
+    vector<double> rank( numNodes, 1.0 / max( numNodes, 1 ) );
+    vector<double> contribution( numNodes );
+    vector<double> partial( graph.numRows() );
+    int numBlocks = graph.numBlocks();
+
+    for ( int iter = 0; iter < iterations; iter++ ) {
+        parallelFor( 0, numNodes, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t u = lo; u < hi; u++ )
+                contribution[u] = outDegree[u] > 0 ? rank[u] / outDegree[u] : 0;
+        } );
+
+        for ( int s = 0; s < graph.numSegments; s++ ) {
+            parallelForDynamic( graph.segmentRowStart[s], graph.segmentRowStart[s + 1], 1024, [&]( int, size_t lo, size_t hi ) {
+                for ( size_t r = lo; r < hi; r++ ) {
+                    double sum = 0;
+                    for ( int e = graph.rowOffset[r]; e < graph.rowOffset[r + 1]; e++ )
+                        sum += contribution[graph.edges[e]];
+                    partial[r] = sum;
+                } // for
+            } );
+        } // for
+
+        parallelForDynamic( 0, numBlocks, 1, [&]( int, size_t lo, size_t hi ) {
+            for ( size_t b = lo; b < hi; b++ ) {
+                int first = b * graph.segmentSize;
+                int last = min<int64_t>( numNodes, (int64_t)( b + 1 ) * graph.segmentSize );
+                for ( int v = first; v < last; v++ )
+                    rank[v] = 0;
+
+                for ( int s = 0; s < graph.numSegments; s++ ) {
+                    const int * start = graph.mergeStart.data() + (size_t)s * ( numBlocks + 1 );
+                    for ( int r = start[b]; r < start[b + 1]; r++ )
+                        rank[graph.rowID[r]] += partial[r];
+                } // for
+
+                for ( int v = first; v < last; v++ )
+                    rank[v] = base + PAGERANK_DAMPING * rank[v];
+            } // for
+        } );
+    } // for
+
+    return rank;
+} // segmentedPageRank
+
+// ---------------------------------------- 分段 CSR 檔
+// magic "REORDSEG"、numOfNodes、numOfEdges、segmentSize、numSegments、列數（各 8 bytes），
+// 接著 segmentRowStart、rowID、rowOffset、edges、mergeStart（皆為 4 bytes 的整數）
+const char SEGMENTED_FILE_MAGIC[8] = { 'R', 'E', 'O', 'R', 'D', 'S', 'E', 'G' };
+
+inline void writeSegmentedFile( const string & fileName, const SegmentedGraph & graph ) {
+    ofstream outputFile( fileName, ios::binary );
+    if ( !outputFile ) {
+        cerr << "Error: Unable to open output file." << endl;
+        exit(1);
+    } // if
+
+    uint64_t fields[5] = { (uint64_t)graph.numOfNodes, (uint64_t)graph.numOfEdges, (uint64_t)graph.segmentSize,
+                           (uint64_t)graph.numSegments, (uint64_t)graph.numRows() };
+    outputFile.write( SEGMENTED_FILE_MAGIC, sizeof( SEGMENTED_FILE_MAGIC ) );
+    outputFile.write( reinterpret_cast<const char *>( fields ), sizeof( fields ) );
+    for ( const vector<int> * section : { &graph.segmentRowStart, &graph.rowID, &graph.rowOffset, &graph.edges, &graph.mergeStart } )
+        outputFile.write( reinterpret_cast<const char *>( section->data() ), section->size() * sizeof( int ) );
+    if ( !outputFile ) {
+        cerr << "Error: Unable to write output file." << endl;
+        exit(1);
+    } // if
+
+    outputFile.close();
+} // writeSegmentedFile
+
+inline void loadSegmentedFile( const string & fileName, SegmentedGraph & graph ) {
+    ifstream input( fileName, ios::binary | ios::ate );
+    uint64_t fileSize = input ? (uint64_t)input.tellg() : 0;
+    input.seekg( 0 );
+    char magic[8];
+    uint64_t fields[5];
+    input.read( magic, sizeof( magic ) );
+    input.read( reinterpret_cast<char *>( fields ), sizeof( fields ) );
+    if ( !input || memcmp( magic, SEGMENTED_FILE_MAGIC, sizeof( magic ) ) != 0 ) {
+        cerr << "Error: not a segmented CSR file." << endl;
+        exit(1);
+    } // if
+
+    // header 的值都要放得進 int，段數必須與 segmentCSR 算出的一致，每列至少一條邊
+    uint64_t numNodes = fields[0], numEdges = fields[1], segmentSize = fields[2], numSegments = fields[3], numRows = fields[4];
+    if ( numNodes > INT_MAX || numEdges > INT_MAX || segmentSize == 0 || segmentSize > INT_MAX || numRows > numEdges ||
+         numSegments != max<uint64_t>( 1, ( numNodes + segmentSize - 1 ) / segmentSize ) ) {
+        cerr << "Error: file illegal, segmented CSR header is out of range." << endl;
+        exit(1);
+    } // if
+
+    // 各區段的大小由 header 決定，合計必須剛好是檔案剩下的大小（讀之前先檢查，壞掉的 header 不會配置過大的陣列）
+    uint64_t numBlocks = ( numNodes + segmentSize - 1 ) / segmentSize;
+    uint64_t headerBytes = sizeof( magic ) + sizeof( fields );
+    uint64_t sectionInts = ( numSegments + 1 ) + numRows + ( numRows + 1 ) + numEdges + numSegments * ( numBlocks + 1 );
+    if ( fileSize < headerBytes || fileSize - headerBytes != sectionInts * sizeof( int ) ) {
+        cerr << "Error: file illegal, segmented CSR sections do not match the file size." << endl;
+        exit(1);
+    } // if
+
+    graph.numOfNodes = numNodes;
+    graph.numOfEdges = numEdges;
+    graph.segmentSize = segmentSize;
+    graph.numSegments = numSegments;
+    graph.segmentRowStart.resize( numSegments + 1 );
+    graph.rowID.resize( numRows );
+    graph.rowOffset.resize( numRows + 1 );
+    graph.edges.resize( numEdges );
+    graph.mergeStart.resize( numSegments * ( numBlocks + 1 ) );
+    for ( vector<int> * section : { &graph.segmentRowStart, &graph.rowID, &graph.rowOffset, &graph.edges, &graph.mergeStart } )
+        input.read( reinterpret_cast<char *>( section->data() ), section->size() * sizeof( int ) );
+    if ( !input ) {
+        cerr << "Error: segmented CSR file is truncated." << endl;
+        exit(1);
+    } // if
+
+    const vector<int> & rowStart = graph.segmentRowStart;
+    const vector<int> & rowOffset = graph.rowOffset;
+    if ( rowStart[0] != 0 || rowStart[numSegments] != (int)numRows || rowOffset[0] != 0 || rowOffset[numRows] != (int)numEdges ) {
+        cerr << "Error: file illegal, segmented CSR offsets do not match the row or edge count." << endl;
+        exit(1);
+    } // if
+
+    for ( uint64_t s = 0; s < numSegments; s++ ) {
+        if ( rowStart[s] > rowStart[s + 1] ) {
+            cerr << "Error: file illegal, segmented CSR segment rows are not sorted." << endl;
+            exit(1);
+        } // if
+    } // for
+
+    // 各段並行檢查：rowOffset 不遞減，邊的來源都在這段內；
+    // mergeStart 不遞減且涵蓋這段所有的列，每個區塊的列其 rowID 都落在該區塊內（合併時各區塊才不會寫到同一個節點）
+    vector<char> segmentIllegal( numSegments, 0 );
+    parallelForDynamic( 0, numSegments, 1, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t s = lo; s < hi; s++ ) {
+            bool illegal = false;
+            int64_t firstSource = (int64_t)s * segmentSize, lastSource = min<int64_t>( numNodes, firstSource + segmentSize );
+            for ( int r = rowStart[s]; r < rowStart[s + 1] && !illegal; r++ ) {
+                illegal = rowOffset[r] < 0 || rowOffset[r] > rowOffset[r + 1] || rowOffset[r + 1] > (int)numEdges;
+                for ( int e = rowOffset[r]; e < rowOffset[r + 1] && !illegal; e++ )
+                    illegal = graph.edges[e] < firstSource || graph.edges[e] >= lastSource;
+            } // for
+
+            const int * start = graph.mergeStart.data() + s * ( numBlocks + 1 );
+            illegal |= start[0] != rowStart[s] || start[numBlocks] != rowStart[s + 1];
+            for ( uint64_t b = 0; b < numBlocks && !illegal; b++ ) {
+                int64_t firstNode = (int64_t)b * segmentSize, lastNode = min<int64_t>( numNodes, firstNode + segmentSize );
+                illegal = start[b] > start[b + 1] || start[b + 1] > start[numBlocks];
+                for ( int r = start[b]; r < start[b + 1] && !illegal; r++ )
+                    illegal = graph.rowID[r] < firstNode || graph.rowID[r] >= lastNode;
+            } // for
+
+            segmentIllegal[s] = illegal;
+        } // for
+    } );
+
+    if ( find( segmentIllegal.begin(), segmentIllegal.end(), 1 ) != segmentIllegal.end() ) {
+        cerr << "Error: file illegal, segmented CSR rows, edges or merge offsets are out of range." << endl;
+        exit(1);
+    } // if
+} // loadSegmentedFile
+
+#endif // SEGMENTED_GRAPH_H
@@ -0,0 +1,532 @@
+#ifndef TRAVERSAL_H
+#define TRAVERSAL_H
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "graph.h"
+#include "parallel.h"
+
+using namespace std;
+
+// ---------------------------------------- 方向最佳化 BFS（Beamer）
+// 每一層依 frontier 的大小選擇：
+//   top-down  : 由 frontier（稀疏的節點清單）往外展開出邊
+//   bottom-up : 每個未拜訪的節點檢查入邊中是否有 frontier（bitmap）的節點，找到就停
+// 拜訪順序與執行緒數量無關：
+//   top-down 層與一般 queue BFS 相同，依 ( 父節點順序, 父節點鄰居中的位置 ) 排列
+//   bottom-up 層依 ( 父節點順序, 節點 ID ) 排列，父節點為入邊中第一個在 frontier 的節點
+
+const int BFS_ALPHA = 15;
+const int BFS_BETA = 18;
+
+// top-down 一層：回傳新一層節點（依序）
+inline vector<int> bfsTopDownStep( const CsrGraph & graph, const int * frontier, int frontierStart, int frontierSize,
+                                   const vector<int> & rank, atomic<int> * claim ) {
+    // 單執行緒時直接依序展開，claim 只當作這一層的標記
+    if ( numOfThreads() == 1 ) {
+        vector<int> next;
+        for ( int i = 0; i < frontierSize; i++ ) {
+            int node = frontier[i];
+            for ( int e = graph.offsets[node]; e < graph.offsets[node + 1]; e++ ) {
+                int neighbor = graph.edges[e];
+                if ( rank[neighbor] == -1 && claim[neighbor].load( memory_order_relaxed ) == INT_MAX ) {
+                    claim[neighbor].store( frontierStart + i, memory_order_relaxed );
+                    next.push_back( neighbor );
+                } // if
+            } // for
+        } // for
+
+        for ( int node : next )
+            claim[node].store( INT_MAX, memory_order_relaxed );
+
+        return next;
+    } // if
+
+    // 第一輪：每個未拜訪的鄰居記下順序最前面的父節點
+    parallelForDynamic( 0, frontierSize, 256, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t i = lo; i < hi; i++ ) {
+            int node = frontier[i];
+            int parent = frontierStart + i;
+            for ( int e = graph.offsets[node]; e < graph.offsets[node + 1]; e++ ) {
+                int neighbor = graph.edges[e];
+                if ( rank[neighbor] != -1 )
+                    continue;
+
+                int current = claim[neighbor].load( memory_order_relaxed );
+                while ( parent < current &&
+                        !claim[neighbor].compare_exchange_weak( current, parent, memory_order_relaxed ) ) {
+                } // while
+            } // for
+        } // for
+    } );
+
+    // 第二輪：父節點依鄰居順序收下自己認領的節點，收完把 claim 還原
+    // 以固定大小的區塊切 frontier，區塊結果依序串接，順序與執行緒數量無關
+    size_t grain = 256;
+    size_t numChunks = ( frontierSize + grain - 1 ) / grain;
+    vector<vector<int>> chunkNext( numChunks );
+    parallelForDynamic( 0, numChunks, 1, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t c = lo; c < hi; c++ ) {
+            size_t last = min<size_t>( frontierSize, ( c + 1 ) * grain );
+            for ( size_t i = c * grain; i < last; i++ ) {
+                int node = frontier[i];
+                int parent = frontierStart + i;
+                for ( int e = graph.offsets[node]; e < graph.offsets[node + 1]; e++ ) {
+                    int neighbor = graph.edges[e];
+                    if ( rank[neighbor] == -1 && claim[neighbor].load( memory_order_relaxed ) == parent ) {
+                        chunkNext[c].push_back( neighbor );
+                        claim[neighbor].store( INT_MAX, memory_order_relaxed );
+                    } // if
+                } // for
+            } // for
+        } // for
+    } );
+
+    vector<size_t> chunkOffset( numChunks + 1, 0 );
+    for ( size_t c = 0; c < numChunks; c++ )
+        chunkOffset[c + 1] = chunkOffset[c] + chunkNext[c].size();
+
+    vector<int> next( chunkOffset[numChunks] );
+    parallelForDynamic( 0, numChunks, 16, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t c = lo; c < hi; c++ )
+            copy( chunkNext[c].begin(), chunkNext[c].end(), next.begin() + chunkOffset[c] );
+    } );
+
+    return next;
+} // bfsTopDownStep
+
+// bottom-up 一層：回傳新一層節點（依序）
+inline vector<int> bfsBottomUpStep( const CsrGraph & inGraph, const int * frontier, int frontierSize,
+                                    const vector<int> & rank, atomic<uint64_t> * frontierBitmap ) {
+    int numNodes = inGraph.numOfNodes;
+    size_t numWords = ( (size_t)numNodes + 63 ) / 64;
+
+    // frontier 清單轉成 bitmap
+    parallelFor( 0, numWords, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t w = lo; w < hi; w++ )
+            frontierBitmap[w].store( 0, memory_order_relaxed );
+    } );
+    parallelFor( 0, frontierSize, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t i = lo; i < hi; i++ ) {
+            int node = frontier[i];
+            frontierBitmap[node / 64].fetch_or( 1ULL << ( node % 64 ), memory_order_relaxed );
+        } // for
+    } );
+
+    // 每個未拜訪的節點找入邊中第一個 frontier 節點當父節點，key = ( 父節點順序, 節點 ID )
+    size_t grain = 4096;
+    size_t numChunks = ( (size_t)numNodes + grain - 1 ) / grain;
+    vector<vector<uint64_t>> chunkKeys( numChunks );
+    parallelForDynamic( 0, numChunks, 1, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t c = lo; c < hi; c++ ) {
+            int last = min<size_t>( numNodes, ( c + 1 ) * grain );
+            for ( int node = c * grain; node < last; node++ ) {
+                if ( rank[node] != -1 )
+                    continue;
+
+                for ( int e = inGraph.offsets[node]; e < inGraph.offsets[node + 1]; e++ ) {
+                    int parent = inGraph.edges[e];
+                    if ( frontierBitmap[parent / 64].load( memory_order_relaxed ) & ( 1ULL << ( parent % 64 ) ) ) {
+                        chunkKeys[c].push_back( ( (uint64_t)rank[parent] << 32 ) | (uint32_t)node );
+                        break;
+                    } // if
+                } // for
+            } // for
+        } // for
+    } );
+
+    vector<size_t> chunkOffset( numChunks + 1, 0 );
+    for ( size_t c = 0; c < numChunks; c++ )
+        chunkOffset[c + 1] = chunkOffset[c] + chunkKeys[c].size();
+
+    vector<uint64_t> keys( chunkOffset[numChunks] );
+    parallelForDynamic( 0, numChunks, 16, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t c = lo; c < hi; c++ )
+            copy( chunkKeys[c].begin(), chunkKeys[c].end(), keys.begin() + chunkOffset[c] );
+    } );
+
+    parallelSort( keys.data(), keys.size() );
+
+    vector<int> next( keys.size() );
+    parallelFor( 0, keys.size(), [&]( int, size_t lo, size_t hi ) {
+        for ( size_t i = lo; i < hi; i++ )
+            next[i] = (uint32_t)keys[i];
+    } );
+
+    return next;
+} // bfsBottomUpStep
+
+// 從 startNode 做方向最佳化 BFS，回傳拜訪順序
+// inGraph 為入邊的 CSR，nullptr 時只做 top-down（有向圖沒有入邊就無法 bottom-up）
+inline vector<int> directionOptimizingBFS( const CsrGraph & graph, const CsrGraph * inGraph, int startNode ) {
+    int numNodes = graph.numOfNodes;
+    vector<int> order;
+    if ( startNode < 0 || startNode >= numNodes )
+        return order;
+
+    // rank[v]：v 在 order 中的位置，-1 表示尚未拜訪
+    vector<int> rank( numNodes );
+    unique_ptr<atomic<int>[]> claim( new atomic<int>[numNodes] );
+    parallelFor( 0, numNodes, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t v = lo; v < hi; v++ ) {
+            rank[v] = -1;
+            claim[v].store( INT_MAX, memory_order_relaxed );
+        } // for
+    } );
+
+    unique_ptr<atomic<uint64_t>[]> frontierBitmap;
+    if ( inGraph != nullptr )
+        frontierBitmap.reset( new atomic<uint64_t>[( (size_t)numNodes + 63 ) / 64] );
+
+    order.resize( numNodes );
+    order[0] = startNode;
+    rank[startNode] = 0;
+    int levelStart = 0, levelEnd = 1;
+    long long unexploredEdges = graph.numOfEdges;
+    int lastFrontierSize = 0;
+    bool bottomUp = false;
+
+    while ( levelStart < levelEnd ) {
+        const int * frontier = order.data() + levelStart;
+        int frontierSize = levelEnd - levelStart;
+
+        // frontier 的出邊數量
+        vector<long long> threadEdges( numOfThreads(), 0 );
+        parallelFor( 0, frontierSize, [&]( int tid, size_t lo, size_t hi ) {
+            long long sum = 0;
+            for ( size_t i = lo; i < hi; i++ )
+                sum += graph.degree( frontier[i] );
+            threadEdges[tid] = sum;
+        } );
+
+        long long frontierEdges = 0;
+        for ( long long sum : threadEdges )
+            frontierEdges += sum;
+
+        if ( !bottomUp && inGraph != nullptr && frontierEdges > unexploredEdges / BFS_ALPHA )
+            bottomUp = true;
+        else if ( bottomUp && frontierSize < numNodes / BFS_BETA && frontierSize < lastFrontierSize )
+            bottomUp = false;
+
+        unexploredEdges -= frontierEdges;
+        lastFrontierSize = frontierSize;
+
+        vector<int> next;
+        if ( bottomUp )
+            next = bfsBottomUpStep( *inGraph, frontier, frontierSize, rank, frontierBitmap.get() );
+        else
+            next = bfsTopDownStep( graph, frontier, levelStart, frontierSize, rank, claim.get() );
+
+        // 新一層接在 order 後面並記錄 rank
+        parallelFor( 0, next.size(), [&]( int, size_t lo, size_t hi ) {
+            for ( size_t i = lo; i < hi; i++ ) {
+                order[levelEnd + i] = next[i];
+                rank[next[i]] = levelEnd + i;
+            } // for
+        } );
+
+        levelStart = levelEnd;
+        levelEnd += next.size();
+    } // while
+
+    order.resize( levelEnd );
+    return order;
+} // directionOptimizingBFS
+
+// 從 start 做 queue BFS，只走 visited 為 0 的節點，拜訪順序寫到 out，回傳拜訪的數量
+inline int bfsFrom( const CsrGraph & graph, int start, vector<char> & visited, int * out ) {
+    int head = 0, tail = 0;
+    out[tail++] = start;
+    visited[start] = 1;
+    while ( head < tail ) {
+        int node = out[head++];
+        for ( int e = graph.offsets[node]; e < graph.offsets[node + 1]; e++ ) {
+            int neighbor = graph.edges[e];
+            if ( !visited[neighbor] ) {
+                visited[neighbor] = 1;
+                out[tail++] = neighbor;
+            } // if
+        } // for
+    } // while
+
+    return tail;
+} // bfsFrom
+
+// DFS 疊代器堆疊的一層：節點與它還沒看過的鄰居範圍 [ next, end )
+struct DFSFrame {
+    int node;
+    const int * next;
+    const int * end;
+    int donated;    // 剩下的鄰居交給其他執行緒時為該工作的編號，否則為 -1（parallelDFS 使用）
+};
+
+// 從 start 做 DFS，只走 visited 為 0 的節點，拜訪順序寫到 out，回傳拜訪的數量
+// 疊代器堆疊：每層記錄節點與下一個要看的鄰居，節點在真正拜訪時才標記並輸出，
+// 因此是真正的 preorder（鄰居依 CSR 中的順序），堆疊最多 O(V) 層，不會像推入所有鄰居那樣長到 O(E)
+inline int dfsFrom( const CsrGraph & graph, int start, vector<char> & visited, int * out ) {
+    int count = 0;
+    vector<DFSFrame> frames;
+    visited[start] = 1;
+    out[count++] = start;
+    frames.push_back( { start, graph.edges + graph.offsets[start], graph.edges + graph.offsets[start + 1], -1 } );
+
+    while ( !frames.empty() ) {
+        DFSFrame & top = frames.back();
+        if ( top.next == top.end ) {
+            frames.pop_back();
+            continue;
+        } // if
+
+        int neighbor = *top.next++;
+        if ( visited[neighbor] )
+            continue;
+
+        visited[neighbor] = 1;
+        out[count++] = neighbor;
+        frames.push_back( { neighbor, graph.edges + graph.offsets[neighbor], graph.edges + graph.offsets[neighbor + 1], -1 } );
+    } // while
+
+    return count;
+} // dfsFrom
+
+// 深度優先搜索 (DFS)
+inline vector<int> dfs( const CsrGraph & graph, int startNode ) {
+    int numNodes = graph.numOfNodes;
+    vector<int> result;
+    if ( startNode < 0 || startNode >= numNodes )
+        return result;
+
+    vector<char> visited( numNodes, 0 );
+    result.resize( numNodes );
+    result.resize( dfsFrom( graph, startNode, visited, result.data() ) );
+    return result;
+} // dfs
+
+// ---------------------------------------- 並行 DFS（工作分享）
+// 依序從 seeds 出發做 DFS，每個執行緒以疊代器堆疊走訪，節點以 atomic 搶到才拜訪。
+// 有執行緒閒置時，忙碌的執行緒每拜訪 DFS_DONATE_INTERVAL 個節點檢查一次，把堆疊最底層
+// （最靠近根，剩下的子樹通常最大）還沒看完的鄰居整段交出去，成為一個新的工作；
+// 還沒走到的 seeds 若有另一組（另一個元件），優先把那些組整段交出去。
+// 每個工作的輸出是一串節點，交出去的工作在原本的工作退出那一層時以佔位記號插入，
+// 也就是單執行緒 DFS 會走到那些鄰居的位置；最後依工作樹展開，每個工作（子樹）佔一段連續的新 ID。
+// 單執行緒時與依序對 seeds 做 dfsFrom 相同；多執行緒時仍是 DFS 式的 preorder，
+// 但節點屬於哪棵子樹與排程有關，結果不固定
+
+const int DFS_DONATE_INTERVAL = 1024;
+
+struct DFSTask {
+    DFSFrame frame;         // 工作的起點：某個節點剩下的鄰居（seeds 本身為 node = -1 的一層）
+    vector<int> items;      // >= 0 為拜訪的節點，< 0 為 -( 子工作編號 + 1 )
+};
+
+// 回傳拜訪順序（從 seeds 走得到的節點）。groupStart 為 seeds 中互不相連的各組（例如連通元件）的起點位置，
+// 交出 seeds 時只從組的邊界切開，同一組的 seeds 不會另起一棵樹和原本的 DFS 搶節點
+inline vector<int> parallelDFS( const CsrGraph & graph, const vector<int> & seeds,
+                                const vector<int> & groupStart = vector<int>() ) {
+    int numNodes = graph.numOfNodes;
+    int numThreads = numOfThreads();
+    unique_ptr<atomic<char>[]> visited( new atomic<char>[numNodes] );
+    parallelFor( 0, numNodes, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t v = lo; v < hi; v++ )
+            visited[v].store( 0, memory_order_relaxed );
+    } );
+
+    // tasks / pending / idle 由 lock 保護；hungry = 閒置的執行緒數 - 等待中的工作數，忙碌時不加鎖讀取
+    mutex lock;
+    condition_variable wake;
+    vector<unique_ptr<DFSTask>> tasks;
+    deque<int> pending;
+    int idle = 0;
+    bool done = false;
+    atomic<int> hungry( -1 );
+    tasks.emplace_back( new DFSTask{ { -1, seeds.data(), seeds.data() + seeds.size(), -1 }, {} } );
+    pending.push_back( 0 );
+
+    auto run = [&]( DFSTask & task, vector<DFSFrame> & frames ) {
+        frames.assign( 1, task.frame );
+        int sinceCheck = 0;
+        while ( !frames.empty() ) {
+            DFSFrame & top = frames.back();
+            if ( top.next == top.end ) {
+                if ( top.donated >= 0 )
+                    task.items.push_back( -( top.donated + 1 ) );
+                frames.pop_back();
+                continue;
+            } // if
+
+            int v = *top.next++;
+            if ( visited[v].load( memory_order_relaxed ) || visited[v].exchange( 1, memory_order_relaxed ) )
+                continue;
+
+            task.items.push_back( v );
+            frames.push_back( { v, graph.edges + graph.offsets[v], graph.edges + graph.offsets[v + 1], -1 } );
+            if ( ++sinceCheck < DFS_DONATE_INTERVAL || hungry.load( memory_order_relaxed ) <= 0 )
+                continue;
+
+            // 先交出後面的整組 seeds，沒有的話交出最底層還有鄰居的節點
+            sinceCheck = 0;
+            DFSFrame * victim = nullptr;
+            const int * split = nullptr;
+            if ( frames[0].node == -1 ) {
+                auto group = upper_bound( groupStart.begin(), groupStart.end(), frames[0].next - seeds.data() - 1 );
+                if ( group != groupStart.end() && seeds.data() + *group < frames[0].end ) {
+                    victim = &frames[0];
+                    split = seeds.data() + *group;
+                } // if
+            } // if
+
+            for ( size_t i = 0; victim == nullptr && i < frames.size(); i++ ) {
+                if ( frames[i].node != -1 && frames[i].next != frames[i].end ) {
+                    victim = &frames[i];
+                    split = victim->next;
+                } // if
+            } // for
+
+            if ( victim == nullptr )
+                continue;
+
+            lock_guard<mutex> guard( lock );
+            victim->donated = tasks.size();
+            tasks.emplace_back( new DFSTask{ { victim->node, split, victim->end, -1 }, {} } );
+            pending.push_back( victim->donated );
+            hungry.fetch_sub( 1, memory_order_relaxed );
+            victim->end = split;
+            wake.notify_one();
+        } // while
+    };
+
+    auto worker = [&]( int ) {
+        vector<DFSFrame> frames;
+        unique_lock<mutex> guard( lock );
+        while ( true ) {
+            while ( pending.empty() && !done ) {
+                idle++;
+                hungry.fetch_add( 1, memory_order_relaxed );
+                if ( idle == numThreads ) {
+                    done = true;
+                    wake.notify_all();
+                } // if
+                else
+                    wake.wait( guard );
+                idle--;
+                hungry.fetch_sub( 1, memory_order_relaxed );
+            } // while
+
+            if ( pending.empty() )
+                return;
+
+            DFSTask * task = tasks[pending.front()].get();
+            pending.pop_front();
+            hungry.fetch_add( 1, memory_order_relaxed );
+            guard.unlock();
+            run( *task, frames );
+            guard.lock();
+        } // while
+    };
+
+    vector<thread> threads;
+    for ( int t = 1; t < numThreads; t++ )
+        threads.push_back( startThread( worker, t ) );
+    worker( 0 );
+    for ( auto & th : threads )
+        th.join();
+
+    // 子工作的編號一定比父工作大：由後往前算每個工作（含子工作）的大小，再由前往後定出起點
+    int numTasks = tasks.size();
+    vector<int> size( numTasks, 0 ), start( numTasks, 0 );
+    for ( int t = numTasks - 1; t >= 0; t-- ) {
+        for ( int item : tasks[t]->items )
+            size[t] += item >= 0 ? 1 : size[-item - 1];
+    } // for
+
+    for ( int t = 0; t < numTasks; t++ ) {
+        int pos = start[t];
+        for ( int item : tasks[t]->items ) {
+            if ( item >= 0 )
+                pos++;
+            else {
+                start[-item - 1] = pos;
+                pos += size[-item - 1];
+            } // else
+        } // for
+    } // for
+
+    vector<int> order( size[0] );
+    parallelForDynamic( 0, numTasks, 1, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t t = lo; t < hi; t++ ) {
+            int pos = start[t];
+            for ( int item : tasks[t]->items ) {
+                if ( item >= 0 )
+                    order[pos++] = item;
+                else
+                    pos += size[-item - 1];
+            } // for
+        } // for
+    } );
+
+    return order;
+} // parallelDFS
+
+// 弱連通元件（忽略邊的方向），並行 union-find：
+// 每條邊把兩端的根以 CAS 接起來，一律由大的根接到小的根，
+// 因此 label[v] 為 v 所在元件中最小的節點 ID，與執行緒數量無關
+inline vector<int> weaklyConnectedComponents( const CsrGraph & graph ) {
+    int numNodes = graph.numOfNodes;
+    unique_ptr<atomic<int>[]> parent( new atomic<int>[numNodes] );
+    parallelFor( 0, numNodes, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t v = lo; v < hi; v++ )
+            parent[v].store( v, memory_order_relaxed );
+    } );
+
+    auto findRoot = [&]( int v ) {
+        int p;
+        while ( ( p = parent[v].load( memory_order_relaxed ) ) != v ) {
+            // path halving
+            int grand = parent[p].load( memory_order_relaxed );
+            if ( grand != p )
+                parent[v].compare_exchange_weak( p, grand, memory_order_relaxed );
+            v = grand;
+        } // while
+
+        return v;
+    };
+
+    parallelForDynamic( 0, numNodes, 1024, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t u = lo; u < hi; u++ ) {
+            for ( int e = graph.offsets[u]; e < graph.offsets[u + 1]; e++ ) {
+                int a = u, b = graph.edges[e];
+                while ( true ) {
+                    a = findRoot( a );
+                    b = findRoot( b );
+                    if ( a == b )
+                        break;
+                    if ( a < b )
+                        swap( a, b );
+
+                    int expected = a;
+                    if ( parent[a].compare_exchange_strong( expected, b, memory_order_relaxed ) )
+                        break;
+                } // while
+            } // for
+        } // for
+    } );
+
+    vector<int> label( numNodes );
+    parallelFor( 0, numNodes, [&]( int, size_t lo, size_t hi ) {
+        for ( size_t v = lo; v < hi; v++ )
+            label[v] = findRoot( v );
+    } );
+
+    return label;
+} // weaklyConnectedComponents
+
+#endif // TRAVERSAL_H